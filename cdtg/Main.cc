@@ -1,5 +1,6 @@
 #include "parseCircuit.h"
 #include "parseCover.h"
+#include "designCache.h"
 #include "Trace.h"
 #include "utils/Options.h"
 
@@ -22,6 +23,17 @@ int main(int argc, char** argv){
   BoolOption nR        ("MAIN", "n", "Negative reset option (-n for negative reset).", false);
   IntOption  covThr    ("MAIN", "t", "Bins covered threshold.", 0, IntRange(0, INT32_MAX));
   IntOption  maxDepth  ("MAIN", "d", "Maximum time frame.", 50, IntRange(0, INT32_MAX));
+  BoolOption coi       ("MAIN", "coi", "Cone-of-influence reduction, only unroll logic reaching covergroup variables.", true);
+  BoolOption aig       ("MAIN", "aig", "AIG reduction, emit CNF from the structurally hashed And-Inverter Graph.", false);
+  IntOption  simCycles ("MAIN", "sim", "Random simulation budget in lane-cycles before SAT solving (0: off).", 0, IntRange(0, INT32_MAX));
+  BoolOption renumber  ("MAIN", "renumber", "Renumber frame variables in fanin order for solver cache locality.", false);
+  BoolOption piDecide  ("MAIN", "pidec", "Decide only on PI, reset and initial-state variables, seed phases from the last model.", false);
+  IntOption  improve   ("MAIN", "improve", "Conflict budget to improve every model toward more uncovered bins (0: off).", 0, IntRange(0, INT32_MAX));
+  BoolOption binPhase  ("MAIN", "binphase", "Prefer the true phase for uncovered bin variables.", false);
+  BoolOption pgBins    ("MAIN", "pg", "Polarity-aware bin CNF, a bin only implies its condition (-no-pg for exact hit counts).", false);
+  IntOption  threads   ("MAIN", "threads", "Threads of the netlist parser (0: one per core).", 0, IntRange(0, INT32_MAX));
+  StringOption cacheDir("MAIN", "cache", "Directory of compiled circuit and covergroup images, reused while the input files are unchanged.");
+  StringOption cellLib ("MAIN", "lib", "Cell library with a truth table per cell, added to the built-in cells.");
   
   parseOptions(argc, argv, true);
   if(argc != 3){
@@ -32,17 +44,30 @@ int main(int argc, char** argv){
   /////////////////////////////////////
   // Start parsing
   
+  CellLibrary cellLibrary;
+  if(cellLib)
+    cellLibrary.read(cellLib);
   Circuit circuit;
-  ParseCircuit circuitParser(&circuit, argv[1], &var);
+  circuit.setLibrary(&cellLibrary);
+  DesignCache designCache(cacheDir);
   initial_time = cpuTime();
-  circuitParser.parse();
+  if(!designCache.load(argv[1], &circuit, &var)){
+    ParseCircuit circuitParser(&circuit, argv[1], &var, threads);
+    circuitParser.parse();
+    designCache.save(circuit, var);
+  }
   parse_time = cpuTime();
   cout << "Circuit parsing time = " << parse_time - initial_time << endl;
   
-  CoverGroup coverGroup;
-  ParseCover coverageParser(&circuit, &coverGroup, argv[2], &var);
+  CoverGroup  coverGroup;
+  BinTemplate binTemplate;
   initial_time = cpuTime();
-  coverageParser.parse();
+  if(!designCache.loadCover(argv[2], pgBins, &coverGroup, &binTemplate, &var)){
+    ParseCover coverageParser(&circuit, &coverGroup, argv[2], &var);
+    coverageParser.parse();
+    binTemplate.generate(&coverGroup, var, pgBins);
+    designCache.saveCover(coverGroup, binTemplate, var);
+  }
   parse_time = cpuTime();
   cout << "Covergroup parsing time = " << parse_time - initial_time << endl;
   
@@ -64,7 +89,8 @@ int main(int argc, char** argv){
   ////////////////////////////////////////////
   // Coverage-driven Test Generation
   
-  Trace trace(circuit, &coverGroup, &var, group, randGroup, nR, covThr, maxDepth);
+  Trace trace(circuit, &coverGroup, &var, group, randGroup, nR, covThr, maxDepth, coi, aig, simCycles, renumber, piDecide, improve, binPhase, pgBins);
+  trace.setBinTemplate(&binTemplate);
   
   // Default        : -i
   // Group          : -g
@@ -10,27 +10,62 @@ using namespace Minisat;
 
 
 // CREATORS
-Trace::Trace(Circuit& circuit, CoverGroup* coverGroup_p, int* cnfVar_p, const BoolOption& group, const IntOption& randGroup, const BoolOption& nR, const IntOption& covThr, const IntOption& maxDepth)
-	       : d_circuit(circuit), d_group(group), d_randGroup(randGroup), d_nR(nR), d_covThr(covThr), d_maxDepth(maxDepth){
+Trace::Trace(Circuit& circuit, CoverGroup* coverGroup_p, int* cnfVar_p, const BoolOption& group, const IntOption& randGroup, const BoolOption& nR, const IntOption& covThr, const IntOption& maxDepth,
+             const BoolOption& coi, const BoolOption& aig, const IntOption& simCycles, const BoolOption& renumber,
+             const BoolOption& piDecide, const IntOption& improve, const BoolOption& binPhase, const BoolOption& pgBins)
+	       : d_circuit(circuit), d_group(group), d_randGroup(randGroup), d_nR(nR), d_covThr(covThr), d_maxDepth(maxDepth), d_coi(coi), d_aig(aig),
+	         d_simCycles(simCycles), d_renumber(renumber), d_piDecide(piDecide), d_improve(improve), d_binPhase(binPhase), d_pgBins(pgBins){
     d_coverGroup_p   = coverGroup_p;
     d_dimacsCnfVar_p = cnfVar_p;
+    // Compile circuit CNF of one frame, the frame also covers variables of the covergroup
+    vector<int> rootVars;
+    for(int i = 0; i < d_coverGroup_p->numOfVariable(); ++i)
+      for(int j = 0; j < d_coverGroup_p->getVariable(i)->getBitwidth(); ++j)
+        rootVars.push_back(d_coverGroup_p->getVariable(i)->getCnfVar(j));
+    d_frameTemplate.build(d_circuit, rootVars, *d_dimacsCnfVar_p, d_coi, d_aig, d_renumber);
+    if(d_piDecide && !d_frameTemplate.canRestrictDecisions())
+      cout << "Combinational loop, all frame variables stay decision variables" << endl;
+    // The simulators map coverVariables by their circuit CNF variables.
+    // Replay only credits bins while they stay targets for the cover threshold,
+    // with -t=0 a bin the model misses is UNSAT at every earlier frame.
+    d_simReady    = d_simCycles != 0 && d_simulator.build(d_circuit, d_coverGroup_p, d_nR);
+    d_replayReady = d_covThr != 0 && d_replaySim.build(d_circuit, d_coverGroup_p, d_nR, Simulator::SCALAR);
+    // Renumber CNF variables of coverVariables to the frame variables
+    for(int i = 0; i < d_coverGroup_p->numOfVariable(); ++i){
+      CoverVariable* var_p = d_coverGroup_p->getVariable(i);
+      for(int j = 0; j < var_p->getBitwidth(); ++j)
+        var_p->setCnfVar(j, d_frameTemplate.frameVar( var_p->getCnfVar(j) ) + 1);
+      var_p->checkConsistence();
+    }
+    cout << "Frame: " << d_frameTemplate.numGates() << " gates, " << d_frameTemplate.numVars() << " variables, "
+         << d_frameTemplate.numClauses() << " clauses, " << d_frameTemplate.numLatches() << " latches" << endl;
     // Set first variable of frame 0 to 0
     d_initialVar.clear();
     d_initialVar.push_back(0);
     // Initialization
-    d_incrSATConstr.clear();
     d_allSATConstr.resize(1);
     d_patterns.clear();
 }
 
+// MANIPULATORS
+void Trace::setBinTemplate(BinTemplate* binTemplate_p){
+  binTemplate_p->moveTo(&d_binTemplate);
+  d_binTemplate.mapFrameVars(d_frameTemplate);
+}
+
 // MAIN FUNCTIONS
 void Trace::tpg(){
   vec<Lit> lits, assumps;
   vector<BaseBin*> currentUncoverBinList;
+  vector<vector<int> > hitFrames;
   int modelCount = 0;
+  int improvedBins = 0;
+  bool narrowed;
+  int binHits = 0;
   //////////////////////////////////////////////////////
   // Parse uncoverd bins
   parseBinsToBeSolved();
+  simulateBins();
   double initial_time = cpuTime();
   for(int depth = 0; d_uncoverBinList.size() > 0 && depth <= d_maxDepth; ++depth){
   	double current_time = cpuTime();
@@ -43,26 +78,43 @@ void Trace::tpg(){
     if(d_covThr != 0)
       d_allSATConstr.resize(depth + 2);
     assumps.clear();
-    assumps.push( ~mkLit( d_incrSATConstr.at(depth) ) );
+    if(d_binPhase)
+      setBinPhases(depth, d_uncoverBinList, true);
     while(d_solver.solve(assumps)){ // Search current frame until UNSAT
     	++modelCount;
+      narrowed = false;
+      if(d_improve != 0)
+        improvedBins += improveModel(depth, assumps, &narrowed);
+      d_solver.model.copyTo(d_lastModel);
       // Record current pattern
       //genPatterns(depth);
-      // Update & add clause for unsolved bins
+      // Credit bins the model also hits at other frames
+      replayModel(depth, &hitFrames);
+      // Update the target bins
       lits.clear();
-      lits.push( mkLit( d_incrSATConstr.at(depth) ) );
       currentUncoverBinList.clear();
       for(int i = 0; i < d_uncoverBinList.size(); ++i){
-        int var = d_bin2var.at(depth)[d_uncoverBinList.at(i)];
-        if(d_solver.modelValue(var) == l_True){
-        	//assumps.push( ~mkLit(var) );
+        int  var    = d_bin2var.at(depth)[d_uncoverBinList.at(i)];
+        bool satHit = (d_solver.modelValue(var) == l_True);
+        for(int j = 0; j < hitFrames.at(i).size(); ++j){
+          if(satHit && hitFrames.at(i).at(j) == depth)
+            continue;
           d_uncoverBinList.at(i)->plusCount();
+          cout << "**** Bin: " << d_uncoverBinList.at(i)->getName() << " hit at frame " << hitFrames.at(i).at(j) << " by replay" << endl;
+        }
+        if(satHit){
+          d_uncoverBinList.at(i)->plusCount();
+          ++binHits;
+        }
+        if(satHit || hitFrames.at(i).size() > 0){
+        	//assumps.push( ~mkLit(var) );
           if(d_covThr != 0 && d_uncoverBinList.at(i)->getHitCount() < d_covThr){
             lits.push( mkLit(var) );
             currentUncoverBinList.push_back(d_uncoverBinList.at(i));
           }
-          cout << "**** Bin: " << d_uncoverBinList.at(i)->getName() << " hit at frame " << depth
-               << ", solver var = " << var << ", CNF var = " << d_uncoverBinList.at(i)->getCnfVar() << endl;
+          if(satHit)
+            cout << "**** Bin: " << d_uncoverBinList.at(i)->getName() << " hit at frame " << depth
+                 << ", solver var = " << var << ", CNF var = " << d_uncoverBinList.at(i)->getCnfVar() << endl;
         }
         else{
           lits.push( mkLit(var) );
@@ -70,11 +122,17 @@ void Trace::tpg(){
         }
         
       }
-      // Add new constraint clause if a bin is sufficientlly covered
-      if(currentUncoverBinList.size() < d_uncoverBinList.size()){
-        d_solver.addClause_(lits);
+      // Drop the bins sufficientlly covered from the targets
+      if(d_binPhase)
+        setBinPhases(depth, d_uncoverBinList, false);
+      // improveModel() may have left the targets at the bins its last model missed.
+      // The solver keeps the learnt clauses if the new set is a subset of those.
+      if(currentUncoverBinList.size() < d_uncoverBinList.size() || narrowed)
+        d_solver.setTargets(lits);
+      if(currentUncoverBinList.size() < d_uncoverBinList.size())
         d_uncoverBinList = currentUncoverBinList;
-      }
+      if(d_binPhase)
+        setBinPhases(depth, d_uncoverBinList, true);
       
       // Print value of variables
       analyzeSolvedBins(depth);
@@ -86,7 +144,6 @@ void Trace::tpg(){
       // Change assumptions
       if(d_covThr != 0){
         assumps.clear();
-        assumps.push( ~mkLit( d_incrSATConstr.at(depth) ) );
         for(int i = 0; i < d_allSATConstr.at(depth).size(); ++i)
           assumps.push( ~mkLit( d_allSATConstr.at(depth).at(i) ) );
       }
@@ -109,16 +166,19 @@ void Trace::tpg(){
     //} cout << endl;
 
     // Remove UNSAT constraint clause
-    d_solver.addClause( mkLit( d_incrSATConstr.at(depth) ) );
     if(d_covThr != 0){
       for(int i = 0; i < d_allSATConstr.at(depth).size(); ++i)
         d_solver.addClause( mkLit( d_allSATConstr.at(depth).at(i) ) );
     }
   }// End for
+  d_solver.clearTargets();
   
   double tpg_time = cpuTime();
   cout << "Test pattern generation time = " << tpg_time - initial_time << endl;
   cout << "Number of models = " << modelCount << endl;
+  cout << "Bins per model = " << ((modelCount > 0) ? (double)binHits / modelCount : 0) << endl;
+  if(d_improve != 0)
+    cout << "Bins added by model improvement = " << improvedBins << endl;
   if(d_uncoverBinList.size() != 0){
     cout << setfill('=') << setw(20); cout << "=" << endl;
     cout << "  Unsolved Bins :" << endl;
@@ -136,9 +196,11 @@ void Trace::tpg_grouped(){
   vec<Lit> lits, assumps;
   vector<BaseBin*> currentUncoverBinList, currentUncoverGroup;
   int modelCount = 0;
+  int binHits = 0;
   //////////////////////////////////////////////////////
   // Parse uncoverd bins
   parseBinsToBeSolved();
+  simulateBins();
   double initial_time = cpuTime();
   for(int depth = 0; d_uncoverBinList.size() > 0 && depth <= d_maxDepth; ++depth){
     double current_time = cpuTime();
@@ -151,8 +213,11 @@ void Trace::tpg_grouped(){
     if(d_covThr != 0) { d_allSATConstr.resize(depth + 2); }
     assumps.clear();
     assumps.push( ~mkLit( d_groupSATConstr.at(depth).at(0) ) );
+    if(d_binPhase)
+      setBinPhases(depth, d_uncoverBinList, true);
     while(d_solver.solve(assumps)){ // Search current frame until UNSAT
       ++modelCount;
+      d_solver.model.copyTo(d_lastModel);
       // Record current pattern
       //genPatterns(depth);
       // Update & add clause for unsolved bins
@@ -168,6 +233,7 @@ void Trace::tpg_grouped(){
             var = d_bin2var.at(depth)[d_uncoverGroupBinList.at(i).at(j)];
             if(d_solver.modelValue(var) == l_True){
               d_uncoverGroupBinList.at(i).at(j)->plusCount();
+              ++binHits;
               if(d_covThr != 0 && d_uncoverGroupBinList.at(i).at(j)->getHitCount() < d_covThr){
                 lits.push( mkLit(var) );
                 currentUncoverGroup.push_back(d_uncoverGroupBinList.at(i).at(j));
@@ -195,9 +261,13 @@ void Trace::tpg_grouped(){
       }
       
       // Update total uncoverBinList
+      if(d_binPhase)
+        setBinPhases(depth, d_uncoverBinList, false);
       if(currentUncoverBinList.size() < d_uncoverBinList.size()){
         d_uncoverBinList = currentUncoverBinList;
       }
+      if(d_binPhase)
+        setBinPhases(depth, d_uncoverBinList, true);
       
       // Print value of variables
       analyzeSolvedBins(depth);
@@ -229,10 +299,12 @@ void Trace::tpg_grouped(){
         d_solver.addClause( mkLit( d_allSATConstr.at(depth).at(i) ) );
     }
   }// End for
+  d_solver.clearTargets();
   
   double tpg_time = cpuTime();
   cout << "Test pattern generation time = " << tpg_time - initial_time << endl;
   cout << "Number of models = " << modelCount << endl;
+  cout << "Bins per model = " << ((modelCount > 0) ? (double)binHits / modelCount : 0) << endl;
   if(d_uncoverBinList.size() != 0){
     cout << setfill('=') << setw(20); cout << "=" << endl;
     cout << "  Unsolved Bins :" << endl;
@@ -254,6 +326,7 @@ void Trace::tpg_mspsat(){
   //////////////////////////////////////////////////////
   // Parse uncoverd bins
   parseBinsToBeSolved();
+  simulateBins();
   double initial_time = cpuTime();
   for(int depth = 0; d_uncoverBinList.size() > 0 && depth <= d_maxDepth; ++depth){
     double current_time = cpuTime();
@@ -283,6 +356,7 @@ void Trace::tpg_mspsat(){
     	assumps.push( mkLit(var) );
     	if(d_solver.solve(assumps)){// assumption satisfied, one or multiple bins solved
     	  ++modelCount;
+    	  d_solver.model.copyTo(d_lastModel);
     	  // Record current pattern
     	  //genPatterns(depth);
     	  
@@ -335,7 +409,6 @@ void Trace::tpg_mspsat(){
         // Change assumptions
         if(d_covThr != 0){
           assumps.clear();
-          assumps.push( ~mkLit( d_incrSATConstr.at(depth) ) );
           for(int i = 0; i < d_allSATConstr.at(depth).size(); ++i)
             assumps.push( ~mkLit( d_allSATConstr.at(depth).at(i) ) );
         }
@@ -357,6 +430,7 @@ void Trace::tpg_mspsat(){
         d_solver.addClause( mkLit( d_allSATConstr.at(depth).at(i) ) );
     }
   }// End for
+  d_solver.clearTargets();
   
   double tpg_time = cpuTime();
   cout << "Test pattern generation time = " << tpg_time - initial_time << endl;
@@ -379,7 +453,7 @@ void Trace::tpg_noIncrSAT(){
   vector<BaseBin*> currentUncoverBinList;
   d_patterns.clear();
   int modelCount = 0;
-  long int conflicts = 0;
+  long int conflicts = 0, propagations = 0;
   //////////////////////////////////////////////////////
   // Parse uncoverd bins
   parseBinsToBeSolved();
@@ -409,6 +483,7 @@ void Trace::tpg_noIncrSAT(){
       	// Update statistics
       	++modelCount;
       	conflicts += d_solver_p->conflicts;
+      	propagations += d_solver_p->propagations;
         // Update unsolved bins
         currentUncoverBinList.clear();
         for(int i = 0; i < d_uncoverBinList.size(); ++i){
@@ -439,6 +514,7 @@ void Trace::tpg_noIncrSAT(){
       }
       else{
       	conflicts += d_solver_p->conflicts;
+      	propagations += d_solver_p->propagations;
         d_patterns.clear();
         delete d_solver_p;
         break; // goto next frame
@@ -450,6 +526,7 @@ void Trace::tpg_noIncrSAT(){
   cout << "#### Ending status ####" << endl;
   cout << "Number of models = " << modelCount << endl;
   cout << "Conflicts : " << conflicts  << endl;
+  cout << "Propagations : " << propagations << endl;
 }
 
 // Solve bins one by one
@@ -457,7 +534,7 @@ void Trace::tpg_single(){
   vec<Lit> lits, assumps;
   vector<BaseBin*> currentUncoverBinList;
   int modelCount = 0;
-  long int conflicts = 0;
+  long int conflicts = 0, propagations = 0;
   //////////////////////////////////////////////////////
   // Parse uncoverd bins
   parseBinsToBeSolved();
@@ -473,6 +550,7 @@ void Trace::tpg_single(){
       if(d_solver_p->solve( mkLit(var) )){
       	++modelCount;
       	conflicts += d_solver_p->conflicts;
+      	propagations += d_solver_p->propagations;
       	cout << "**** Bin: " << d_uncoverBinList.at(i)->getName() << " hit at frame " << depth << endl;     
         // Print value of variables
         analyzeSolvedBins_noIncrSAT(depth); // Reused noIncrSAT function
@@ -501,6 +579,7 @@ void Trace::tpg_single(){
   cout << "#### Ending status ####" << endl;
   cout << "Number of models = " << modelCount << endl;
   cout << "Conflicts : " << conflicts  << endl;
+  cout << "Propagations : " << propagations << endl;
 }
 
 // UTILITIES
@@ -508,70 +587,14 @@ void Trace::tpg_single(){
 ////////////////////////////////////////////////////////////////////////////////
 // Incremental SAT solving functions, used by tpg()
 void Trace::insert(int frame){
-  int parsedLit, var, dffPortSize, PPI, PPI_N, prePPO;
-  char portChar;
   vec<Lit> lits;
   
   //////////////////////////////////////////////////////
   // Add clauses from circuit
-  for(int i = 0; i < d_circuit.gateListSize(); ++i){
-    lits.clear();
-    const vector<int> gateClause = d_circuit.getGate(i)->getCNFClause();
-    if(gateClause.size() > 0){
-      for(int j = 0; j < gateClause.size(); ++j){
-        parsedLit = gateClause.at(j);
-        if(parsedLit == 0){
-          d_solver.addClause_(lits);
-          lits.clear();
-          continue;
-        }
-        parsedLit = (gateClause.at(j) > 0) ? (gateClause.at(j) + d_initialVar.at(frame)) : (gateClause.at(j) - d_initialVar.at(frame));
-        var = abs(parsedLit) - 1;
-        while(var >= d_solver.nVars()) { d_solver.newVar(); }
-        lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
-      }
-    }
-    else if(d_circuit.getGate(i)->getType() == Gate::DFF && frame >= 1){ // Insert clauses of flip-flops
-      dffPortSize = d_circuit.getGate(i)->dffOutSize();
-      portChar    = d_circuit.getGate(i)->getDFFPort(0);
-      //cout << "DFF port size = " << dffPortSize << ", port char = " << portChar << endl;
-      prePPO  = d_circuit.getGate(i)->getInWire(0)->getCnfVar() - 1 + d_initialVar.at(frame - 1);
-      while(prePPO >= d_solver.nVars()) { d_solver.newVar(); }
-      if(dffPortSize == 1 && portChar == 'Q'){
-        PPI = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI >= d_solver.nVars()) { d_solver.newVar(); }
-        // Connect PPI(t) to PPO(t-1)
-        d_solver.addClause( ~mkLit(PPI),  mkLit(prePPO) );
-        d_solver.addClause(  mkLit(PPI), ~mkLit(prePPO) );
-        // cout << "c Connect PPI(t) to PPO(t-1)" << endl;
-        // cout << -(PPI + 1) << " " <<  (prePPO + 1) << endl;
-        // cout <<  (PPI + 1) << " " << -(prePPO + 1) << endl;
-      }
-      else if(dffPortSize == 1 && portChar == 'N'){
-        PPI_N = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI_N >= d_solver.nVars()) { d_solver.newVar(); }
-        // Connect PPI_N(t) to PPO(t-1)
-        d_solver.addClause( ~mkLit(PPI_N), ~mkLit(prePPO) );
-        d_solver.addClause(  mkLit(PPI_N),  mkLit(prePPO) );
-      }
-      else if(dffPortSize == 2){
-        PPI = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI >= d_solver.nVars()) { d_solver.newVar(); }
-        PPI_N = d_circuit.getGate(i)->getOutWire(1)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI_N >= d_solver.nVars()) { d_solver.newVar(); }
-        // Connect PPI(t) to PPO(t-1)
-        d_solver.addClause( ~mkLit(PPI),    mkLit(prePPO) );
-        d_solver.addClause(  mkLit(PPI),   ~mkLit(prePPO) );
-        // Connect PPI_N(t) to PPO(t-1)
-        d_solver.addClause( ~mkLit(PPI_N), ~mkLit(prePPO) );
-        d_solver.addClause(  mkLit(PPI_N),  mkLit(prePPO) );
-      }
-      else{
-        cout << "Unknown DFF port condition." << endl;
-        cout << "DFF port size = " << dffPortSize << ", port char = " << portChar << endl;
-        exit(1);
-      }
-    }
+  d_frameTemplate.instantiate(d_solver, d_initialVar.at(frame), (frame > 0) ? d_initialVar.at(frame - 1) : -1);
+  if(d_piDecide){
+    d_frameTemplate.restrictDecisions(d_solver, d_initialVar.at(frame), frame > 0);
+    seedPhases(frame);
   }
   
   //////////////////////////////////////////////////////
@@ -582,64 +605,16 @@ void Trace::insert(int frame){
   // Add clauses of uncovered bins
   setBinCNF(frame);
   
-  // for(int i = 0; i < d_circuit.PPIListSize(); ++i){
-  //   if(d_circuit.getPPI(i)->getName().substr(0, 5).compare("count") == 0){
-  //     cout << d_circuit.getPPI(i)->getName() << ": " << d_circuit.getPPI(i)->getCnfVar() + d_initialVar.at(frame) << endl;
-  //   }
-  // }
-  // CoverVariable* var_p = d_coverGroup_p->getVariable((string)"count");
-  // for(int i = 0; i < var_p->getBitwidth(); ++i){
-  //   cout << i << " :" << var_p->getCnfVar(i) << endl;
-  // }
-  
-  for(int i = 0; i < d_uncoverBinList.size(); ++i){
-    //cout << "CNF Clause of bin: " << d_uncoverBinList.at(i)->getName() << endl;
-    const vector<int> binClause = d_uncoverBinList.at(i)->getCNFClause();
-    lits.clear();
-    for(int j = 0; j < binClause.size(); ++j){
-      parsedLit = binClause.at(j);
-      if(parsedLit == 0){
-        // for(int i = 0; i < lits.size(); ++i){
-        //   int lit = toInt( lits[i] );
-        //   if((lit%2)==0)
-        //     cout << (lit/2) + 1 << " ";
-        //   else
-        //     cout << -((lit+1)/2) << " ";
-        // }
-        // cout << endl;
-        d_solver.addClause_(lits);
-        lits.clear();
-        continue;
-      }
-      var = abs(parsedLit) - 1;
-      while(var >= d_solver.nVars()) { d_solver.newVar(); }
-      lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
-    }
-  }
+  d_binTemplate.instantiate(d_solver, d_initialVar.at(frame));
   
   //////////////////////////////////////////////////////
   // Create constraint variable & clauses
   if(!d_group){
-    d_solver.newVar();
-    d_incrSATConstr.resize(frame + 1);
-    d_incrSATConstr.at(frame) = d_solver.nVars() - 1;
-    
-    // Add constraint clause
+    // Models of this frame must hit an uncovered bin, the targets of the previous frame are retired
     lits.clear();
-    lits.push( mkLit( d_incrSATConstr.at(frame) ) );
     for(int i = 0; i < d_uncoverBinList.size(); ++i)
       lits.push( mkLit( d_bin2var.at(frame)[d_uncoverBinList.at(i)] ) );
-    d_solver.addClause_(lits);
-    
-    // cout << " Constraint clause" << endl;
-    // for(int i = 0; i < lits.size(); ++i){
-    //   int lit = toInt( lits[i] );
-    //   if((lit%2)==0)
-    //     cout << (lit/2) + 1 << " ";
-    //   else
-    //     cout << -((lit+1)/2) << " ";
-    // }
-    // cout << endl;
+    d_solver.setTargets(lits);
   }
   else{
   	vector<int> temp;
@@ -680,30 +655,31 @@ void Trace::addSpecConstraint(int frame){
   if(frame == 0){  // Initial conditions
     // Set all PI to 0
     for(int i = 0; i < d_circuit.PIListSize(); ++i)
-      d_solver.addClause( ~mkLit( d_circuit.getPI(i)->getCnfVar() - 1) );
+      d_solver.addClause( ~mkLit( d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(i)) )) );
     // Set all PPI to 0
     for(int i = 0; i < d_circuit.PPIListSize(); ++i)
-      d_solver.addClause( ~mkLit( d_circuit.getPPI(i)->getCnfVar() - 1) );
+      if((var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPPI(i)) )) >= 0) // PPI outside the cone has no variable
+        d_solver.addClause( ~mkLit(var) );
       
     if(d_nR){ // Set all RST to 0
       for(int i = 0; i < d_circuit.RSTListSize(); ++i)
-        d_solver.addClause( ~mkLit( d_circuit.getRST(i)->getCnfVar() - 1) );
+        d_solver.addClause( ~mkLit( d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) )) );
     }
     else{ // Set all RST to 1
       for(int i = 0; i < d_circuit.RSTListSize(); ++i)
-        d_solver.addClause( mkLit( d_circuit.getRST(i)->getCnfVar() - 1) );
+        d_solver.addClause( mkLit( d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) )) );
     }
   }
   else{
     if(d_nR){ // Set all RST to 1
       for(int i = 0; i < d_circuit.RSTListSize(); ++i){
-        var = d_circuit.getRST(i)->getCnfVar() - 1 + d_initialVar.at(frame);
+        var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) ) + d_initialVar.at(frame);
         d_solver.addClause( mkLit(var) );
       }
     }
     else{ // Set all RST to 0
       for(int i = 0; i < d_circuit.RSTListSize(); ++i){
-        var = d_circuit.getRST(i)->getCnfVar() - 1 + d_initialVar.at(frame);
+        var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) ) + d_initialVar.at(frame);
         d_solver.addClause( ~mkLit(var) );
       }
     }
@@ -716,16 +692,6 @@ void Trace::addSpecConstraint(int frame){
 
 void Trace::setBinCNF(int frame){
   int var;
-  // Reset all CNF variables of state bins
-  for(int i = 0; i < d_coverGroup_p->numOfCoverPoint(); ++i)
-    for(int j = 0; j < d_coverGroup_p->getCoverPoint(i)->numOfBin(); ++j)
-      d_coverGroup_p->getCoverPoint(i)->getBin(j)->setCnfVar(-1);
-  
-  // Reset all CNF variables of cross bins
-  for(int i = 0; i < d_coverGroup_p->numOfCross(); ++i)
-    for(int j = 0; j < d_coverGroup_p->getCross(i)->numOfBin(); ++j)
-      d_coverGroup_p->getCross(i)->getBin(j)->setCnfVar(-1);
-
   // Set CNF variable of coverVariables to consist with circuit CNF variable
   if(frame > 0)
     for(int i = 0; i < d_coverGroup_p->numOfVariable(); ++i)
@@ -733,6 +699,12 @@ void Trace::setBinCNF(int frame){
 
   // Set d_dimacsCnfVar_p to new max variable
   (*d_dimacsCnfVar_p) = d_solver.nVars();
+  const int binVar = *d_dimacsCnfVar_p;
+
+  // The bin CNF of the previous frame is shifted to this frame while the uncovered bins stay the same
+  const bool reuse = d_binTemplate.matches(d_uncoverBinList);
+  if(!reuse)
+    d_coverGroup_p->resetBinCnf();
 
   // Set CNF variable of uncovered bins at frame t
   for(int i = 0; i < d_uncoverBinList.size(); ++i){
@@ -744,9 +716,15 @@ void Trace::setBinCNF(int frame){
     d_var2bin[var] = d_uncoverBinList.at(i);
   }
   
+  if(reuse){
+    (*d_dimacsCnfVar_p) = binVar + d_binTemplate.numVars();
+    return;
+  }
+
   // Generate CNF clauses of uncovered bins
   for(int i = 0; i < d_uncoverBinList.size(); ++i)
-    d_uncoverBinList.at(i)->genCnf(d_dimacsCnfVar_p); // Call genCnf() of each bin
+    d_uncoverBinList.at(i)->genCnf(d_dimacsCnfVar_p, d_pgBins); // Call genCnf() of each bin
+  d_binTemplate.capture(d_uncoverBinList, d_initialVar.at(frame), binVar);
 }
 
 void Trace::analyzeSolvedBins(int frame){
@@ -790,9 +768,9 @@ void Trace::analyzeSolvedBins(int frame){
   // Print RST
   for(int i = 0; i < d_circuit.RSTListSize(); ++i){
     cout << setfill(' ') << setw(14);
-    cout << d_circuit.getRST(i)->getName() << ":";
+    cout << d_circuit.getWireName(d_circuit.getRST(i)) << ":";
     for(int t = 0; t <= frame; ++t){
-      var = d_circuit.getRST(i)->getCnfVar() - 1 + d_initialVar.at(t);
+      var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) ) + d_initialVar.at(t);
       cout << setfill(' ') << setw(5);
       var = (d_solver.modelValue(var) == l_True) ? 1 : 0;
       cout << var;
@@ -814,6 +792,84 @@ void Trace::analyzeSolvedBins(int frame){
   cout << setfill('=') << setw(15 + 5 * (frame + 2)); cout << "=" << endl;
 }
 
+// The decision heuristic tries the bin variables of the frame true (preferTrue)
+// or at the default false phase. Phase saving overwrites these phases on
+// backtracking, so tpg() sets them again after every model.
+void Trace::setBinPhases(int frame, const vector<BaseBin*>& bins, bool preferTrue){
+  for(int i = 0; i < bins.size(); ++i)
+    d_solver.setPolarity(d_bin2var.at(frame)[bins.at(i)], !preferTrue);
+}
+
+// Make the current model of the frame hit more uncovered bins: the bins it hits
+// are assumed and one more is required through the solver targets, until no
+// model hits more or the conflict budget runs out. If *narrowed_p is set the
+// targets are left at the bins the last model missed, the caller sets them
+// again. The model hitting the most bins is left in the solver, returns the
+// number of bins added.
+int Trace::improveModel(int frame, const vec<Lit>& assumps, bool* narrowed_p){
+  vec<Lit>   hits, missed;
+  vec<lbool> kept;     // Model to restore if the next call fails
+  int first = -1, last = 0;
+
+  d_solver.setConfBudget(d_improve);
+  while(true){
+    assumps.copyTo(hits);
+    missed.clear();
+    for(int i = 0; i < d_uncoverBinList.size(); ++i){
+      int var = d_bin2var.at(frame)[d_uncoverBinList.at(i)];
+      if(d_solver.modelValue(var) == l_True)
+        hits.push( mkLit(var) );
+      else
+        missed.push( mkLit(var) );
+    }
+    last = hits.size() - assumps.size();
+    if(first < 0)
+      first = last;
+    if(missed.size() == 0)
+      break;
+    d_solver.model.copyTo(kept);
+    d_solver.setTargets(missed);
+    *narrowed_p = true;
+    if(d_solver.solveLimited(hits) != l_True){
+      kept.copyTo(d_solver.model);  // A failed call clears the model
+      break;
+    }
+  }
+  d_solver.budgetOff();
+  return last - first;
+}
+
+// A new frame starts from the phases the last model gave the previous frame,
+// the search then looks for a bin close to a known reachable trace
+void Trace::seedPhases(int frame){
+  if(frame == 0 || d_lastModel.size() < d_initialVar.at(frame))
+    return;
+  for(int v = 0; v < d_frameTemplate.numVars(); ++v)
+    d_solver.setPolarity(d_initialVar.at(frame) + v, d_lastModel[d_initialVar.at(frame - 1) + v] == l_False);
+}
+
+// Replay the PI sequence of the current model in lane 0 of the replay simulator,
+// hitFrames[i] gives the frames 0 ... frame where d_uncoverBinList[i] is hit.
+// Bins of LOCAL variables are never hit by the replay, nothing is hit with -t=0.
+void Trace::replayModel(int frame, vector<vector<int> >* hitFrames){
+  vector<vector<char> > piBits;
+  
+  hitFrames->assign(d_uncoverBinList.size(), vector<int>());
+  if(!d_replayReady)
+    return;
+  modelPIs(frame, &piBits);
+  d_replaySim.reset();
+  for(int t = 0; t <= frame; ++t){
+    if(t > 0){
+      d_replaySim.loadPI(0, piBits.at(t));
+      d_replaySim.step();
+    }
+    for(int i = 0; i < d_uncoverBinList.size(); ++i)
+      if(d_uncoverBinList.at(i)->simHit(d_replaySim, 0) & 1)
+        hitFrames->at(i).push_back(t);
+  }
+}
+
 void Trace::addAllSATConstraint(int frame){
   vec<Lit> lits;
   int var;
@@ -821,7 +877,7 @@ void Trace::addAllSATConstraint(int frame){
   for(int t = 0; t < frame; ++t){
     lits.clear();
     for(int i = 0; i < d_circuit.PIListSize(); ++i){
-      var = d_circuit.getPI(i)->getCnfVar() - 1 + d_initialVar.at(t);
+      var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(i)) ) + d_initialVar.at(t);
       if(d_solver.modelValue(var) == l_True)
         lits.push( ~mkLit(var) );
       else
@@ -847,71 +903,13 @@ void Trace::addAllSATConstraint(int frame){
 ////////////////////////////////////////////////////////////////////////////////
 // Non-incremental SAT solving functions, used by tpg_noIncrSAT()
 void Trace::insert_noIncrSAT(int frame, int maxframe){
-  int parsedLit, var, dffPortSize, PPI, PPI_N, prePPO;
-  char portChar;
   vec<Lit> lits;
   
   //////////////////////////////////////////////////////
   // Add clauses from circuit
-  for(int i = 0; i < d_circuit.gateListSize(); ++i){
-    lits.clear();
-    const vector<int> gateClause = d_circuit.getGate(i)->getCNFClause();
-    if(gateClause.size() > 0){
-      for(int j = 0; j < gateClause.size(); ++j){
-        parsedLit = gateClause.at(j);
-        if(parsedLit == 0){
-          d_solver_p->addClause_(lits);
-          lits.clear();
-          continue;
-        }
-        parsedLit = (gateClause.at(j) > 0) ? (gateClause.at(j) + d_initialVar.at(frame)) : (gateClause.at(j) - d_initialVar.at(frame));
-        var = abs(parsedLit) - 1;
-        while(var >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
-      }
-    }
-    else if(d_circuit.getGate(i)->getType() == Gate::DFF && frame >= 1){ // Insert clauses of flip-flops
-      dffPortSize = d_circuit.getGate(i)->dffOutSize();
-      portChar    = d_circuit.getGate(i)->getDFFPort(0);
-      //cout << "DFF port size = " << dffPortSize << ", port char = " << portChar << endl;
-      prePPO  = d_circuit.getGate(i)->getInWire(0)->getCnfVar() - 1 + d_initialVar.at(frame - 1);
-      while(prePPO >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-      if(dffPortSize == 1 && portChar == 'Q'){
-        PPI = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        // Connect PPI(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI),  mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI), ~mkLit(prePPO) );
-        // cout << "c Connect PPI(t) to PPO(t-1)" << endl;
-        // cout << -(PPI + 1) << " " <<  (prePPO + 1) << endl;
-        // cout <<  (PPI + 1) << " " << -(prePPO + 1) << endl;
-      }
-      else if(dffPortSize == 1 && portChar == 'N'){
-        PPI_N = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI_N >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        // Connect PPI_N(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI_N), ~mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI_N),  mkLit(prePPO) );
-      }
-      else if(dffPortSize == 2){
-        PPI = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        PPI_N = d_circuit.getGate(i)->getOutWire(1)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI_N >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        // Connect PPI(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI),    mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI),   ~mkLit(prePPO) );
-        // Connect PPI_N(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI_N), ~mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI_N),  mkLit(prePPO) );
-      }
-      else{
-        cout << "Unknown DFF port condition." << endl;
-        cout << "DFF port size = " << dffPortSize << ", port char = " << portChar << endl;
-        exit(1);
-      }
-    }
-  }
+  d_frameTemplate.instantiate(*d_solver_p, d_initialVar.at(frame), (frame > 0) ? d_initialVar.at(frame - 1) : -1);
+  if(d_piDecide)
+    d_frameTemplate.restrictDecisions(*d_solver_p, d_initialVar.at(frame), frame > 0);
   
   //////////////////////////////////////////////////////
   // Add spec constraint clauses
@@ -921,21 +919,7 @@ void Trace::insert_noIncrSAT(int frame, int maxframe){
   // Add clauses of uncovered bins
   setBinCNF_noIncrSAT(frame);
   
-  for(int i = 0; i < d_uncoverBinList.size(); ++i){
-    const vector<int> binClause = d_uncoverBinList.at(i)->getCNFClause();
-    lits.clear();
-    for(int j = 0; j < binClause.size(); ++j){
-      parsedLit = binClause.at(j);
-      if(parsedLit == 0){
-        d_solver_p->addClause_(lits);
-        lits.clear();
-        continue;
-      }
-      var = abs(parsedLit) - 1;
-      while(var >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-      lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
-    }
-  }
+  d_binTemplate.instantiate(*d_solver_p, d_initialVar.at(frame));
   
   // Add bin-solving constraint clauses
   if(frame == maxframe){
@@ -958,30 +942,31 @@ void Trace::addSpecConstraint_noIncrSAT(int frame){
   if(frame == 0){  // Initial conditions
     // Set all PI to 0
     for(int i = 0; i < d_circuit.PIListSize(); ++i)
-      d_solver_p->addClause( ~mkLit( d_circuit.getPI(i)->getCnfVar() - 1) );
+      d_solver_p->addClause( ~mkLit( d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(i)) )) );
     // Set all PPI to 0
     for(int i = 0; i < d_circuit.PPIListSize(); ++i)
-      d_solver_p->addClause( ~mkLit( d_circuit.getPPI(i)->getCnfVar() - 1) );
+      if((var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPPI(i)) )) >= 0) // PPI outside the cone has no variable
+        d_solver_p->addClause( ~mkLit(var) );
     
     if(d_nR){ // Set all RST to 0
       for(int i = 0; i < d_circuit.RSTListSize(); ++i)
-        d_solver_p->addClause( ~mkLit( d_circuit.getRST(i)->getCnfVar() - 1) );
+        d_solver_p->addClause( ~mkLit( d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) )) );
     }
     else{ // Set all RST to 1
       for(int i = 0; i < d_circuit.RSTListSize(); ++i)
-        d_solver_p->addClause( mkLit( d_circuit.getRST(i)->getCnfVar() - 1) );
+        d_solver_p->addClause( mkLit( d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) )) );
     }
   }
   else{
     if(d_nR){ // Set all RST to 1
       for(int i = 0; i < d_circuit.RSTListSize(); ++i){
-        var = d_circuit.getRST(i)->getCnfVar() - 1 + d_initialVar.at(frame);
+        var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) ) + d_initialVar.at(frame);
         d_solver_p->addClause( mkLit(var) );
       }
     }
     else{ // Set all RST to 0
       for(int i = 0; i < d_circuit.RSTListSize(); ++i){
-        var = d_circuit.getRST(i)->getCnfVar() - 1 + d_initialVar.at(frame);
+        var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) ) + d_initialVar.at(frame);
         d_solver_p->addClause( ~mkLit(var) );
       }
     }
@@ -994,16 +979,6 @@ void Trace::addSpecConstraint_noIncrSAT(int frame){
 
 void Trace::setBinCNF_noIncrSAT(int frame){
   int var;
-  // Reset all CNF variables of state bins
-  for(int i = 0; i < d_coverGroup_p->numOfCoverPoint(); ++i)
-    for(int j = 0; j < d_coverGroup_p->getCoverPoint(i)->numOfBin(); ++j)
-      d_coverGroup_p->getCoverPoint(i)->getBin(j)->setCnfVar(-1);
-  
-  // Reset all CNF variables of cross bins
-  for(int i = 0; i < d_coverGroup_p->numOfCross(); ++i)
-    for(int j = 0; j < d_coverGroup_p->getCross(i)->numOfBin(); ++j)
-      d_coverGroup_p->getCross(i)->getBin(j)->setCnfVar(-1);
-
   // Set CNF variable of coverVariables to consist with circuit CNF variable
   if(frame > 0){
     for(int i = 0; i < d_coverGroup_p->numOfVariable(); ++i)
@@ -1016,6 +991,12 @@ void Trace::setBinCNF_noIncrSAT(int frame){
   
   // Set d_dimacsCnfVar_p to new max variable
   (*d_dimacsCnfVar_p) = d_solver_p->nVars();
+  const int binVar = *d_dimacsCnfVar_p;
+
+  // The bin CNF of the previous frame is shifted to this frame while the uncovered bins stay the same
+  const bool reuse = d_binTemplate.matches(d_uncoverBinList);
+  if(!reuse)
+    d_coverGroup_p->resetBinCnf();
 
   // Set CNF variable of uncovered bins at frame t
   for(int i = 0; i < d_uncoverBinList.size(); ++i){
@@ -1027,9 +1008,15 @@ void Trace::setBinCNF_noIncrSAT(int frame){
     d_var2bin[var] = d_uncoverBinList.at(i);
   }
   
+  if(reuse){
+    (*d_dimacsCnfVar_p) = binVar + d_binTemplate.numVars();
+    return;
+  }
+
   // Generate CNF clauses of uncovered bins
   for(int i = 0; i < d_uncoverBinList.size(); ++i)
-    d_uncoverBinList.at(i)->genCnf(d_dimacsCnfVar_p); // Call genCnf() of each bin
+    d_uncoverBinList.at(i)->genCnf(d_dimacsCnfVar_p, d_pgBins); // Call genCnf() of each bin
+  d_binTemplate.capture(d_uncoverBinList, d_initialVar.at(frame), binVar);
 }
 
 void Trace::analyzeSolvedBins_noIncrSAT(int frame){
@@ -1073,9 +1060,9 @@ void Trace::analyzeSolvedBins_noIncrSAT(int frame){
   // Print RST
   for(int i = 0; i < d_circuit.RSTListSize(); ++i){
     cout << setfill(' ') << setw(14);
-    cout << d_circuit.getRST(i)->getName() << ":";
+    cout << d_circuit.getWireName(d_circuit.getRST(i)) << ":";
     for(int t = 0; t <= frame; ++t){
-      var = d_circuit.getRST(i)->getCnfVar() - 1 + d_initialVar.at(t);
+      var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getRST(i)) ) + d_initialVar.at(t);
       cout << setfill(' ') << setw(5);
       var = (d_solver_p->modelValue(var) == l_True) ? 1 : 0;
       cout << var;
@@ -1107,7 +1094,7 @@ void Trace::addAllSATConstraint_noIncrSAT(int frame){
   if(frame == 0){
     lits.clear();
     for(int j = 0; j < d_circuit.PIListSize(); ++j){
-      var = d_circuit.getPI(j)->getCnfVar() - 1;
+      var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(j)) );
       lits.push( mkLit(var) );
     }
     d_solver_p->addClause_(lits);
@@ -1119,7 +1106,7 @@ void Trace::addAllSATConstraint_noIncrSAT(int frame){
       for(int t = 0; t < frame; ++t){
         vector<int>& tPattern = pattern.at(t);
         for(int j = 0; j < d_circuit.PIListSize(); ++j){
-          var = d_circuit.getPI(j)->getCnfVar() - 1 + d_initialVar.at(t);
+          var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(j)) ) + d_initialVar.at(t);
           if(tPattern.at(j) == 1)
             lits.push( ~mkLit(var) );
           else
@@ -1149,7 +1136,7 @@ void Trace::recordPatterns(int frame){
     for(int t = 0; t < frame; ++t){
       tPattern.clear();
       for(int i = 0; i < d_circuit.PIListSize(); ++i){
-        var = d_circuit.getPI(i)->getCnfVar() - 1 + d_initialVar.at(t);
+        var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(i)) ) + d_initialVar.at(t);
         if(d_solver_p->modelValue(var) == l_True)
           tPattern.push_back(1);
         else
@@ -1164,71 +1151,13 @@ void Trace::recordPatterns(int frame){
 ////////////////////////////////////////////////////////////////////////////////
 // Single SAT solving functions, used by tpg_single()
 void Trace::insert_single(int frame, int binIdx){
-  int parsedLit, var, dffPortSize, PPI, PPI_N, prePPO;
-  char portChar;
   vec<Lit> lits;
   
   //////////////////////////////////////////////////////
   // Add clauses from circuit
-  for(int i = 0; i < d_circuit.gateListSize(); ++i){
-    lits.clear();
-    const vector<int> gateClause = d_circuit.getGate(i)->getCNFClause();
-    if(gateClause.size() > 0){
-      for(int j = 0; j < gateClause.size(); ++j){
-        parsedLit = gateClause.at(j);
-        if(parsedLit == 0){
-          d_solver_p->addClause_(lits);
-          lits.clear();
-          continue;
-        }
-        parsedLit = (gateClause.at(j) > 0) ? (gateClause.at(j) + d_initialVar.at(frame)) : (gateClause.at(j) - d_initialVar.at(frame));
-        var = abs(parsedLit) - 1;
-        while(var >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
-      }
-    }
-    else if(d_circuit.getGate(i)->getType() == Gate::DFF && frame >= 1){ // Insert clauses of flip-flops
-      dffPortSize = d_circuit.getGate(i)->dffOutSize();
-      portChar    = d_circuit.getGate(i)->getDFFPort(0);
-      //cout << "DFF port size = " << dffPortSize << ", port char = " << portChar << endl;
-      prePPO  = d_circuit.getGate(i)->getInWire(0)->getCnfVar() - 1 + d_initialVar.at(frame - 1);
-      while(prePPO >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-      if(dffPortSize == 1 && portChar == 'Q'){
-        PPI = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        // Connect PPI(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI),  mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI), ~mkLit(prePPO) );
-        // cout << "c Connect PPI(t) to PPO(t-1)" << endl;
-        // cout << -(PPI + 1) << " " <<  (prePPO + 1) << endl;
-        // cout <<  (PPI + 1) << " " << -(prePPO + 1) << endl;
-      }
-      else if(dffPortSize == 1 && portChar == 'N'){
-        PPI_N = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI_N >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        // Connect PPI_N(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI_N), ~mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI_N),  mkLit(prePPO) );
-      }
-      else if(dffPortSize == 2){
-        PPI = d_circuit.getGate(i)->getOutWire(0)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        PPI_N = d_circuit.getGate(i)->getOutWire(1)->getCnfVar() - 1 + d_initialVar.at(frame);
-        while(PPI_N >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-        // Connect PPI(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI),    mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI),   ~mkLit(prePPO) );
-        // Connect PPI_N(t) to PPO(t-1)
-        d_solver_p->addClause( ~mkLit(PPI_N), ~mkLit(prePPO) );
-        d_solver_p->addClause(  mkLit(PPI_N),  mkLit(prePPO) );
-      }
-      else{
-        cout << "Unknown DFF port condition." << endl;
-        cout << "DFF port size = " << dffPortSize << ", port char = " << portChar << endl;
-        exit(1);
-      }
-    }
-  }
+  d_frameTemplate.instantiate(*d_solver_p, d_initialVar.at(frame), (frame > 0) ? d_initialVar.at(frame - 1) : -1);
+  if(d_piDecide)
+    d_frameTemplate.restrictDecisions(*d_solver_p, d_initialVar.at(frame), frame > 0);
   
   //////////////////////////////////////////////////////
   // Add spec constraint clauses
@@ -1238,19 +1167,7 @@ void Trace::insert_single(int frame, int binIdx){
   // Add clauses of a single uncovered bin
   setBinCNF_single(frame, binIdx);
   
-  const vector<int> binClause = d_uncoverBinList.at(binIdx)->getCNFClause();
-  lits.clear();
-  for(int j = 0; j < binClause.size(); ++j){
-    parsedLit = binClause.at(j);
-    if(parsedLit == 0){
-      d_solver_p->addClause_(lits);
-      lits.clear();
-      continue;
-    }
-    var = abs(parsedLit) - 1;
-    while(var >= d_solver_p->nVars()) { d_solver_p->newVar(); }
-    lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
-  }
+  addBinClauses(*d_solver_p, vector<BaseBin*>(1, d_uncoverBinList.at(binIdx)));
  
   //////////////////////////////////////////////////////
   // Update first variable of next frame
@@ -1260,8 +1177,9 @@ void Trace::insert_single(int frame, int binIdx){
 
 void Trace::setBinCNF_single(int frame, int binIdx){
   int var;
-  // Reset the CNF variable of the bin
+  // Reset the CNF variable of the bin, and the coverpoint decoders and cross terms of the previous frame or solver
   d_uncoverBinList.at(binIdx)->setCnfVar(-1);
+  d_coverGroup_p->resetEncoders();
 
   // Set CNF variable of coverVariables to consist with circuit CNF variable
   if(frame > 0){
@@ -1284,11 +1202,166 @@ void Trace::setBinCNF_single(int frame, int binIdx){
   d_var2bin[var] = d_uncoverBinList.at(binIdx);
   
   // Generate CNF clauses of the uncovered bin
-  d_uncoverBinList.at(binIdx)->genCnf(d_dimacsCnfVar_p);
+  d_uncoverBinList.at(binIdx)->genCnf(d_dimacsCnfVar_p, d_pgBins);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Utility functions
+////////////////////////////////////////////////////////////////////////////////
+// Simulation warm start
+
+// Append PI values of a lane at frames fromT ... toT of a simulation run
+static void appendLanePIs(const vector<vector<SimWord> >& runPI, int words, int lane, int fromT, int toT,
+                          vector<vector<char> >* piBits_p){
+  for(int t = fromT; t <= toT; ++t){
+    const int numPI = runPI.at(t).size() / words;
+    piBits_p->push_back(vector<char>(numPI));
+    for(int i = 0; i < numPI; ++i)
+      piBits_p->back().at(i) = (runPI.at(t).at(i * words + lane / Simulator::LANES) >> (lane % Simulator::LANES)) & 1;
+  }
+}
+
+// Random simulation before SAT solving. Every run starts all lanes at frame 0
+// and clocks them up to the maximum depth, half of the lanes continue from the
+// states which credited the most bins in earlier runs. Bins hit by a lane are
+// credited once per frame, their PI sequence is written as a pattern, and bins
+// reaching the cover threshold are removed from the SAT targets.
+void Trace::simulateBins(){
+  vector<SimSeed>          seeds, newSeeds;
+  vector<vector<SimWord> > runPI;          // runPI[t][i * words + k] gives word k of PI i at frame t of the run
+  vector<int>              laneSeed;       // Seed a lane continues from, -1 if it started from reset
+  vector<vector<char> >    piBits;
+  vector<BaseBin*>         currentUncoverBinList;
+  map<int, int>            laneScore;      // Bins credited by a lane in the current frame
+  long long                cycles = 0;
+  int                      runs = 0, idleRuns = 0, hits = 0;
+  const int                bias[3] = {0, -1, 1};
+  
+  if(!d_simReady || d_simCycles == 0 || d_uncoverBinList.size() == 0)
+    return;
+  const int words = d_simulator.numWords();
+  const int lanes = d_simulator.numLanes();
+  double initial_time = cpuTime();
+  
+  while(cycles < d_simCycles && d_uncoverBinList.size() > 0 && idleRuns < SIM_IDLE_RUNS){
+    int credited = 0;
+    d_simulator.setBias(bias[runs % 3]);
+    d_simulator.reset();
+    laneSeed.assign(lanes, -1);
+    if(seeds.size() > 0)
+      for(int lane = lanes / 2; lane < lanes; ++lane){
+        laneSeed.at(lane) = (lane - lanes / 2) % seeds.size();
+        d_simulator.loadState(lane, seeds.at(laneSeed.at(lane)).state);
+      }
+    runPI.clear();
+    newSeeds.clear();
+    
+    for(int t = 0; t <= d_maxDepth && d_uncoverBinList.size() > 0 && cycles < d_simCycles; ++t){
+      if(t > 0)
+        d_simulator.step();
+      runPI.push_back(vector<SimWord>(d_circuit.PIListSize() * words));
+      for(int i = 0; i < d_circuit.PIListSize(); ++i)
+        for(int k = 0; k < words; ++k)
+          runPI.back().at(i * words + k) = d_simulator.piValue(i, k);
+      cycles += lanes;
+      
+      // Lanes beyond the maximum depth are masked out
+      vector<SimWord> active(words, ~(SimWord)0);
+      for(int lane = 0; lane < lanes; ++lane)
+        if(t > 0 && laneSeed.at(lane) >= 0 && seeds.at(laneSeed.at(lane)).frame + t > d_maxDepth)
+          active.at(lane / Simulator::LANES) &= ~((SimWord)1 << (lane % Simulator::LANES));
+      
+      laneScore.clear();
+      currentUncoverBinList.clear();
+      for(int i = 0; i < d_uncoverBinList.size(); ++i){
+        BaseBin* bin_p = d_uncoverBinList.at(i);
+        int      lane  = -1;
+        for(int k = 0; k < words && lane < 0; ++k){
+          SimWord hit = bin_p->simHit(d_simulator, k) & active.at(k);
+          if(hit != 0)
+            lane = k * Simulator::LANES + __builtin_ctzll(hit);
+        }
+        if(lane < 0){
+          currentUncoverBinList.push_back(bin_p);
+          continue;
+        }
+        int seed  = (t > 0) ? laneSeed.at(lane) : -1;
+        int frame = (seed >= 0) ? seeds.at(seed).frame + t : t;
+        bin_p->plusCount();
+        ++hits;
+        ++credited;
+        ++laneScore[lane];
+        cout << "**** Bin: " << bin_p->getName() << " hit at frame " << frame << " by simulation" << endl;
+        if(d_covThr != 0 && bin_p->getHitCount() < d_covThr)
+          currentUncoverBinList.push_back(bin_p);
+      }
+      d_uncoverBinList = currentUncoverBinList;
+      
+      // Record the PI sequence of every hitting lane once, whatever the number of
+      // bins it hits, and keep the states of these lanes
+      for(map<int, int>::iterator it = laneScore.begin(); it != laneScore.end(); ++it){
+        int lane  = it->first;
+        int seed  = (t > 0) ? laneSeed.at(lane) : -1;
+        int frame = (seed >= 0) ? seeds.at(seed).frame + t : t;
+        piBits.clear();
+        if(seed >= 0){
+          piBits = seeds.at(seed).piBits;
+          appendLanePIs(runPI, words, lane, 1, t, &piBits);
+        }
+        else
+          appendLanePIs(runPI, words, lane, 0, t, &piBits);
+        writePattern(piBits);
+        if(frame >= d_maxDepth)
+          continue;
+        newSeeds.push_back(SimSeed());
+        d_simulator.saveState(lane, &newSeeds.back().state);
+        newSeeds.back().piBits.swap(piBits);
+        newSeeds.back().frame = frame;
+        newSeeds.back().score = it->second;
+      }
+    }
+    
+    // Merge new seeds, the least productive ones are replaced when full
+    for(int i = 0; i < newSeeds.size(); ++i){
+      if(seeds.size() < SIM_SEEDS){
+        seeds.push_back(newSeeds.at(i));
+        continue;
+      }
+      int worst = 0;
+      for(int j = 1; j < seeds.size(); ++j)
+        if(seeds.at(j).score < seeds.at(worst).score)
+          worst = j;
+      if(seeds.at(worst).score < newSeeds.at(i).score)
+        seeds.at(worst) = newSeeds.at(i);
+    }
+    idleRuns = (credited > 0) ? 0 : idleRuns + 1;
+    ++runs;
+  }
+  
+  // Remove covered bins from groups
+  if(d_uncoverGroupBinList.size() > 0){
+    set<BaseBin*> uncovered(d_uncoverBinList.begin(), d_uncoverBinList.end());
+    vector<vector<BaseBin*> > groups;
+    for(int i = 0; i < d_uncoverGroupBinList.size(); ++i){
+      vector<BaseBin*> group;
+      for(int j = 0; j < d_uncoverGroupBinList.at(i).size(); ++j)
+        if(uncovered.count(d_uncoverGroupBinList.at(i).at(j)))
+          group.push_back(d_uncoverGroupBinList.at(i).at(j));
+      if(group.size() > 0)
+        groups.push_back(group);
+    }
+    d_uncoverGroupBinList = groups;
+  }
+  
+  double sim_time = cpuTime() - initial_time;
+  cout << "Simulation: " << runs << " runs, " << cycles << " cycles (" << d_simulator.kernelName() << "), "
+       << hits << " hits, " << d_uncoverBinList.size() << " bins left" << endl;
+  cout << "Simulation time = " << sim_time;
+  if(sim_time > 0)
+    cout << ", " << cycles / sim_time / 1e6 << " Mcycles/s";
+  cout << endl;
+}
+
 void Trace::parseBinsToBeSolved(){
   CoverPoint* coverPoint_p;
   Cross*      cross_p;
@@ -1368,6 +1441,31 @@ void Trace::parseBinsToBeSolved(){
   }
 }
 
+// Load the CNF of bins as one batch, variables are reserved at once
+void Trace::addBinClauses(Solver& solver, const vector<BaseBin*>& binList){
+  vec<Lit> lits;
+  vec<int> clauseBegin;
+  int      parsedLit, var, maxVar = solver.nVars() - 1;
+
+  clauseBegin.push(0);
+  for(int i = 0; i < binList.size(); ++i){
+    const vector<int>& binClause = binList.at(i)->getCNFClause();
+    for(int j = 0; j < binClause.size(); ++j){
+      parsedLit = binClause.at(j);
+      if(parsedLit == 0){
+        clauseBegin.push(lits.size());
+        continue;
+      }
+      var = abs(parsedLit) - 1;
+      if(var > maxVar) maxVar = var;
+      lits.push( (parsedLit > 0) ? mkLit(var) : ~mkLit(var) );
+    }
+  }
+  if(maxVar >= solver.nVars())
+    solver.newVars(maxVar + 1 - solver.nVars());
+  solver.addClauses(lits, clauseBegin);
+}
+
 long int Trace::bitvector2int(const int& bitWidth, const vector<int>& bitString){
   long int val = 0;
   for(int i = 0; i < bitWidth; ++i){
@@ -1377,56 +1475,59 @@ long int Trace::bitvector2int(const int& bitWidth, const vector<int>& bitString)
 }
 
 void Trace::genPatterns(int frame){
+  vector<vector<char> > piBits;
+  modelPIs(frame, &piBits);
+  writePattern(piBits);
+}
+
+// piBits[t][i] gives the model value of PI i at frame t
+void Trace::modelPIs(int frame, vector<vector<char> >* piBits){
+  int var;
+  piBits->assign(frame + 1, vector<char>(d_circuit.PIListSize(), 0));
+  for(int t = 0; t <= frame; ++t)
+    for(int i = 0; i < d_circuit.PIListSize(); ++i){
+      var = d_frameTemplate.frameVar( d_circuit.getCnfVar(d_circuit.getPI(i)) ) + d_initialVar.at(t);
+      piBits->at(t).at(i) = (d_solver.modelValue(var) == l_True) ? 1 : 0;
+    }
+}
+
+// piBits[t][i] gives the value of PI i at frame t
+void Trace::writePattern(const vector<vector<char> >& piBits){
   
   static ofstream p("patterns.p");
   static int pnum = 1;
-  string CLK = d_circuit.getCLK(0)->getName();
-  string RST = d_circuit.getRST(0)->getName();
+  string CLK = d_circuit.getWireName(d_circuit.getCLK(0));
   string temp, temp2, name;
-  Wire* w;
+  int w;
   vector<int> bitString;
-  int var, find1, find2;
+  int find1, find2;
   long value;
   
   p << "Pattern # " << pnum++ << endl;
-  for(int t = 0; t <= frame; ++t){
+  for(int t = 0; t < piBits.size(); ++t){
     p << "@(negedge " << CLK << ")" << endl;
     for(int i = 0; i < d_circuit.PIListSize(); ++i){
       w = d_circuit.getPI(i);
-      temp = w->getName();
-      //p << "temp = " << temp << endl;
+      temp = d_circuit.getWireName(w);
       bitString.clear();
       if((find1 = temp.find_first_of('[')) == string::npos){ // single bit
         name = temp;
-        var  = w->getCnfVar() + d_initialVar.at(t) - 1;
-        bitString.push_back(0);
-        bitString.at(0) = (d_solver.modelValue(var) == l_True) ? 1 : 0;
+        bitString.push_back(piBits.at(t).at(i));
       }
       else{ // multi bit
         name = temp.substr(0, find1);
-        var  = w->getCnfVar() + d_initialVar.at(t) - 1;
-        bitString.push_back(0);
-        bitString.at(0) = (d_solver.modelValue(var) == l_True) ? 1 : 0;
-        int idx = 1;
+        bitString.push_back(piBits.at(t).at(i));
         for(int j = i + 1; j < d_circuit.PIListSize(); ++i, ++j){
           w = d_circuit.getPI(j);
-          temp2 = w->getName();
-          //p << "temp2 = " << temp2 << endl;
+          temp2 = d_circuit.getWireName(w);
           if((find2 = temp2.find_first_of('[')) != string::npos){
-            if(name.compare( temp2.substr(0, find2) ) == 0){
-              var  = w->getCnfVar() + d_initialVar.at(t) - 1;
-              bitString.push_back(0);
-              bitString.at(idx++) = (d_solver.modelValue(var) == l_True) ? 1 : 0;
-            }
+            if(name.compare( temp2.substr(0, find2) ) == 0)
+              bitString.push_back(piBits.at(t).at(j));
             else break;
           }
           else break;
         }
       }
-      //p << "bitString = " << bitString.size() << "'d";
-      //for(int k = 0; k < bitString.size(); ++k)
-      //  p << bitString.at(k);
-      //p << endl;
       value = bitvector2int(bitString.size(), bitString);
       p << name << " = " << bitString.size() << "'d" << value << ";" << endl;
     }
@@ -1438,6 +1539,7 @@ void Trace::printStats(){
 	cout << "Variables : " << d_solver.nVars()    << endl;
 	cout << "Learns    : " << d_solver.nLearnts() << endl;
 	cout << "Conflicts : " << d_solver.conflicts  << endl;
+	cout << "Propagations : " << d_solver.propagations << endl;
 }
 
 void Trace::printStats_(){
@@ -1445,5 +1547,6 @@ void Trace::printStats_(){
 	cout << "Variables : " << d_solver_p->nVars()    << endl;
 	cout << "Learns    : " << d_solver_p->nLearnts() << endl;
 	cout << "Conflicts : " << d_solver_p->conflicts  << endl;
+	cout << "Propagations : " << d_solver_p->propagations << endl;
 }
 
@@ -8,6 +8,9 @@
 #include "global.h"
 #include "coverGroup.h"
 #include "circuit.h"
+#include "frameTemplate.h"
+#include "binTemplate.h"
+#include "simulator.h"
 
 #include "core/Solver.h"
 #include "utils/System.h"
@@ -18,6 +21,15 @@ using namespace Minisat;
 
 class Trace{
     private:
+        // Simulation state worth continuing from, see simulateBins()
+        struct SimSeed{
+          vector<char>          state;    // PPI of frame (frame + 1)
+          vector<vector<char> > piBits;   // piBits[t][i] gives PI i at frame t, t = 0 ... frame
+          int                   frame;
+          int                   score;    // Bins credited when the state was reached
+        };
+        enum {SIM_SEEDS = 64, SIM_IDLE_RUNS = 16};
+        
         // DATA
         Circuit&                      d_circuit;
         CoverGroup*                   d_coverGroup_p;
@@ -27,18 +39,32 @@ class Trace{
         const BoolOption&             d_nR;               // Negative reset
         const IntOption&              d_covThr;           // Cover threshould
         const IntOption&              d_maxDepth;         // Maximum time frame
+        const BoolOption&             d_coi;              // Cone-of-influence reduction of the circuit
+        const BoolOption&             d_aig;              // AIG reduction of the circuit
+        const IntOption&              d_simCycles;        // Random simulation budget (lane-cycles) before SAT solving
+        const BoolOption&             d_renumber;         // Renumber frame variables for locality
+        const BoolOption&             d_piDecide;         // Decide only on frame inputs, gate outputs follow by propagation
+        const IntOption&              d_improve;          // Conflict budget to improve every model of tpg() toward more uncovered bins
+        const BoolOption&             d_binPhase;         // Phase of uncovered bin variables set to true
+        const BoolOption&             d_pgBins;           // Bin CNF with the bin -> condition direction only
         Solver                        d_solver;
         Solver*                       d_solver_p;         // used for non-incremental SAT
+        FrameTemplate                 d_frameTemplate;    // Circuit CNF of one frame, instantiated by every insert function
+        BinTemplate                   d_binTemplate;      // CNF of the uncovered bins, instantiated by insert() and insert_noIncrSAT()
+        Simulator                     d_simulator;        // Random simulation of simulateBins(), only built with -sim
+        bool                          d_simReady;
+        Simulator                     d_replaySim;        // One word simulator of replayModel(), only built with -t
+        bool                          d_replayReady;
         
         ifstream                      d_inUncoverBinFile;
                                      
         vector<BaseBin*>              d_uncoverBinList;
         vector<vector<BaseBin*> >     d_uncoverGroupBinList;
         vector<int>                   d_initialVar;       // d_initialVar[t] gives the first variable of frame t
+        vec<lbool>                    d_lastModel;        // Model of the last SAT answer of d_solver, seeds the phases of a new frame
         vector<map<BaseBin*, int> >   d_bin2var;          // bin2var[t][b] gives the variable of bin b in frame t
         map<int, BaseBin*>            d_var2bin;          // var2bin[v] gives the bin of variable v
                                      
-        vector<int>                   d_incrSATConstr;    // d_incrSATConstr[t] gives the auxilary variable of incremental SAT solving of frame t
         vector<vector<int> >          d_allSATConstr;     // d_allSATConstr[t][i] gives the auxilary variable i of all SAT solving of frame t, 
                                                           //   used by addAllSATConstraint(int frame)
         vector<vector<int> >          d_groupSATConstr;
@@ -47,7 +73,12 @@ class Trace{
     
     public:
         // CREATORS
-        Trace(Circuit&, CoverGroup*, int*, const BoolOption&, const IntOption&, const BoolOption&, const IntOption&, const IntOption&);
+        Trace(Circuit&, CoverGroup*, int*, const BoolOption&, const IntOption&, const BoolOption&, const IntOption&, const IntOption&,
+              const BoolOption&, const BoolOption&, const IntOption&, const BoolOption&, const BoolOption&, const IntOption&,
+              const BoolOption&, const BoolOption&);
+  
+        // MANIPULATORS
+        void setBinTemplate(BinTemplate*);   // Take over the CNF of all bins from BinTemplate::generate(), reused by the first frame
   
         // MAIN FUNCTIONS
         void tpg           ();
@@ -64,6 +95,10 @@ class Trace{
         void setBinCNF                     (int frame);
         void analyzeSolvedBins             (int frame);
         void addAllSATConstraint           (int frame);
+        void replayModel                   (int frame, vector<vector<int> >* hitFrames);
+        void seedPhases                    (int frame);
+        int  improveModel                  (int frame, const vec<Lit>& assumps, bool* narrowed_p);
+        void setBinPhases                  (int frame, const vector<BaseBin*>& bins, bool preferTrue);
         
         // Non-incremental SAT solving functions, used by tpg_noIncrSAT()
         void insert_noIncrSAT              (int frame, int maxframe);
@@ -77,10 +112,16 @@ class Trace{
         void insert_single                 (int frame, int binIdx);
         void setBinCNF_single              (int frame, int binIdx);
         
+        // Simulation warm start, used by tpg(), tpg_grouped() and tpg_mspsat()
+        void simulateBins                  ();
+        
         // Utility functions
         void parseBinsToBeSolved           ();
+        void addBinClauses                 (Solver&, const vector<BaseBin*>&);
         long bitvector2int                 (const int&, const vector<int>&);
         void genPatterns                   (int frame);
+        void modelPIs                      (int frame, vector<vector<char> >* piBits);
+        void writePattern                  (const vector<vector<char> >& piBits);
         void printStats                    ();
         void printStats_                   ();
 };
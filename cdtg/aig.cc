@@ -0,0 +1,230 @@
+#include "aig.h"
+#include <iostream>
+#include <stdlib.h>
+
+using namespace std;
+
+// CREATORS
+Aig::Aig(){
+  d_numAnds = 0;
+}
+
+// MANIPULATORS
+bool Aig::build(Circuit& circuit, int numVars){
+  int maxVar = numVars;
+  vector<int>   stack;
+  vector<int>   inLits;
+
+  for(int i = 0; i < circuit.wireListSize(); ++i)
+    if(circuit.getCnfVar(i) > maxVar)
+      maxVar = circuit.getCnfVar(i);
+
+  d_fanin0.clear();
+  d_fanin1.clear();
+  d_leafVar.clear();
+  d_latchNode.clear();
+  d_latchNext.clear();
+  d_strash.clear();
+  d_numAnds = 0;
+  d_wireLit.assign(maxVar + 1, -1);
+
+  // Node 0 is the constant
+  d_fanin0.push_back(-1);
+  d_fanin1.push_back(-1);
+  d_leafVar.push_back(0);
+
+  //////////////////////////////////////////////////////
+  // Evaluate wires in topological order,
+  // state 0: not visited, 1: waiting for its fanins, 2: done
+  vector<char> state(maxVar + 1, 0);
+  for(int i = 0; i < circuit.wireListSize(); ++i){
+    stack.push_back(i);
+    while(!stack.empty()){
+      int wire = stack.back();
+      int v    = circuit.getCnfVar(wire);
+      int gate = circuit.getSourceGate(wire);
+      if(state.at(v) == 2){
+        stack.pop_back();
+        continue;
+      }
+      // Flip-flop outputs and undriven wires are leaves
+      if(gate < 0 || circuit.getGateType(gate) == Gate::DFF ||
+         (circuit.getGateType(gate) != Gate::CELL && gateLit(circuit.getGateType(gate), vector<int>()) < 0)){
+        d_wireLit.at(v) = 2 * newLeaf(v);
+        state.at(v) = 2;
+        stack.pop_back();
+        continue;
+      }
+      if(state.at(v) == 0){
+        state.at(v) = 1;
+        for(int j = 0; j < circuit.inputSize(gate); ++j){
+          int in = circuit.getInWire(gate, j);
+          if(state.at(circuit.getCnfVar(in)) == 1){
+            cout << "Combinational loop through wire " << circuit.getWireName(in) << ", AIG reduction skipped." << endl;
+            return false;
+          }
+          if(state.at(circuit.getCnfVar(in)) == 0)
+            stack.push_back(in);
+        }
+        continue;
+      }
+      // All fanins are done
+      inLits.clear();
+      for(int j = 0; j < circuit.inputSize(gate); ++j)
+        inLits.push_back(d_wireLit.at(circuit.getCnfVar(circuit.getInWire(gate, j))));
+      if(circuit.getGateType(gate) == Gate::CELL){
+        int k = 0;
+        while(circuit.getOutWire(gate, k) != wire)
+          ++k;
+        d_wireLit.at(v) = cellLit(*circuit.getLibrary(),
+                                  circuit.getLibrary()->output(circuit.getCell(gate), circuit.getPort(gate, k) - '0'), inLits);
+      }
+      else
+        d_wireLit.at(v) = gateLit(circuit.getGateType(gate), inLits);
+      state.at(v) = 2;
+      stack.pop_back();
+    }
+  }
+
+  // Variables without a wire (LOCAL covergroup variables) are leaves
+  for(int v = 1; v <= maxVar; ++v)
+    if(d_wireLit.at(v) < 0)
+      d_wireLit.at(v) = 2 * newLeaf(v);
+
+  //////////////////////////////////////////////////////
+  // Flip-flops: PPI(t) == PPO(t-1), QN ports take the negated PPO
+  for(int i = 0; i < circuit.dffListSize(); ++i){
+    int gate   = circuit.getDFF(i);
+    int prePPO = d_wireLit.at(circuit.getCnfVar(circuit.getInWire(gate, 0)));
+    for(int j = 0; j < circuit.outputSize(gate); ++j){
+      char portChar = circuit.getPort(gate, j);
+      if(portChar != 'Q' && portChar != 'N'){
+        cout << "Unknown DFF port condition." << endl;
+        cout << "DFF port size = " << circuit.outputSize(gate) << ", port char = " << portChar << endl;
+        exit(1);
+      }
+      d_latchNode.push_back(node(d_wireLit.at(circuit.getCnfVar(circuit.getOutWire(gate, j)))));
+      d_latchNext.push_back((portChar == 'Q') ? prePPO : (prePPO ^ 1));
+    }
+  }
+  return true;
+}
+
+int Aig::newLeaf(int cnfVar){
+  d_fanin0.push_back(-1);
+  d_fanin1.push_back(-1);
+  d_leafVar.push_back(cnfVar);
+  return d_fanin0.size() - 1;
+}
+
+int Aig::mkAnd(int a, int b){
+  if(a > b) { int t = a; a = b; b = t; }
+  if(a == 0)       return 0;   // 0 & b
+  if(a == 1)       return b;   // 1 & b
+  if(a == b)       return a;
+  if((a ^ 1) == b) return 0;   // a & !a
+  map<pair<int, int>, int>::iterator it = d_strash.find(make_pair(a, b));
+  if(it != d_strash.end())
+    return 2 * it->second;
+  d_fanin0.push_back(a);
+  d_fanin1.push_back(b);
+  d_leafVar.push_back(0);
+  ++d_numAnds;
+  d_strash[make_pair(a, b)] = d_fanin0.size() - 1;
+  return 2 * (d_fanin0.size() - 1);
+}
+
+int Aig::mkOr(int a, int b){
+  return mkAnd(a ^ 1, b ^ 1) ^ 1;
+}
+
+int Aig::mkXor(int a, int b){
+  return mkOr( mkAnd(a, b ^ 1), mkAnd(a ^ 1, b) );
+}
+
+int Aig::mkMux(int s, int a1, int a0){
+  return mkOr( mkAnd(s, a1), mkAnd(s ^ 1, a0) );
+}
+
+// Literal of the gate output, -1 if the gate type has no logic function.
+// Input order follows Circuit::setCNF().
+int Aig::gateLit(Gate::gateType type, const vector<int>& in){
+  bool check = in.empty();
+  switch(type){
+    case Gate::BUF:    return check ? 0 : in.at(0);
+    case Gate::INV:    return check ? 0 : in.at(0) ^ 1;
+    case Gate::AND2:   return check ? 0 : mkAnd(in.at(0), in.at(1));
+    case Gate::AND3:   return check ? 0 : mkAnd(mkAnd(in.at(0), in.at(1)), in.at(2));
+    case Gate::OR2:    return check ? 0 : mkOr(in.at(0), in.at(1));
+    case Gate::OR3:    return check ? 0 : mkOr(mkOr(in.at(0), in.at(1)), in.at(2));
+    case Gate::NAND2:  return check ? 0 : mkAnd(in.at(0), in.at(1)) ^ 1;
+    case Gate::NAND3:  return check ? 0 : mkAnd(mkAnd(in.at(0), in.at(1)), in.at(2)) ^ 1;
+    case Gate::NAND4:  return check ? 0 : mkAnd(mkAnd(in.at(0), in.at(1)), mkAnd(in.at(2), in.at(3))) ^ 1;
+    case Gate::NOR2:   return check ? 0 : mkOr(in.at(0), in.at(1)) ^ 1;
+    case Gate::NOR3:   return check ? 0 : mkOr(mkOr(in.at(0), in.at(1)), in.at(2)) ^ 1;
+    case Gate::XOR2:   return check ? 0 : mkXor(in.at(0), in.at(1));
+    case Gate::XNOR2:  return check ? 0 : mkXor(in.at(0), in.at(1)) ^ 1;
+    case Gate::MX2:    return check ? 0 : mkMux(in.at(2), in.at(1), in.at(0));             // (S0 B) | ((!S0) A)
+    case Gate::OAI21:  return check ? 0 : mkAnd(mkOr(in.at(0), in.at(1)), in.at(2)) ^ 1;   // !((A0 | A1) B0)
+    case Gate::AOI21:  return check ? 0 : mkOr(mkAnd(in.at(0), in.at(1)), in.at(2)) ^ 1;   // !((A0 A1) | B0)
+    case Gate::CONST0: return 0;
+    case Gate::CONST1: return 1;
+    default:           return -1;
+  }
+}
+
+// ACCESSORS
+int Aig::numNodes() const{
+  return d_fanin0.size();
+}
+
+int Aig::numAnds() const{
+  return d_numAnds;
+}
+
+int Aig::numLatches() const{
+  return d_latchNode.size();
+}
+
+bool Aig::isAnd(int node) const{
+  return d_fanin0.at(node) >= 0;
+}
+
+int Aig::fanin0(int node) const{
+  return d_fanin0.at(node);
+}
+
+int Aig::fanin1(int node) const{
+  return d_fanin1.at(node);
+}
+
+int Aig::leafVar(int node) const{
+  return d_leafVar.at(node);
+}
+
+int Aig::wireLit(int cnfVar) const{
+  return d_wireLit.at(cnfVar);
+}
+
+int Aig::latchNode(int i) const{
+  return d_latchNode.at(i);
+}
+
+int Aig::latchNext(int i) const{
+  return d_latchNext.at(i);
+}
+
+// Sum of products over the smaller cover of the output, complemented for the off-set
+int Aig::cellLit(const CellLibrary& library, int output, const vector<int>& in){
+  bool                     onSet = library.coverSize(output, true) <= library.coverSize(output, false);
+  const CellLibrary::Cube* cube  = library.getCover(output, onSet);
+  int                      lit   = 0;
+  for(int c = 0; c < library.coverSize(output, onSet); ++c){
+    int term = 1;
+    for(int i = 0; i < in.size(); ++i)
+      if((cube[c].mask >> i) & 1)
+        term = mkAnd(term, ((cube[c].value >> i) & 1) ? in.at(i) : in.at(i) ^ 1);
+    lit = mkOr(lit, term);
+  }
+  return onSet ? lit : lit ^ 1;
+}
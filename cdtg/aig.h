@@ -0,0 +1,60 @@
+#ifndef INCLUDED_AIG
+#define INCLUDED_AIG
+
+#include <vector>
+#include <map>
+#include "circuit.h"
+
+using namespace std;
+
+// Structurally hashed And-Inverter Graph of one time frame of the circuit.
+// A literal is 2 * node + complement, node 0 is constant 0 (literal 1 is constant 1).
+// Leaves are PI, CLK, RST, flip-flop outputs (PPI), undriven wires and covergroup
+// variables without a wire. Constants are propagated, buffer and inverter chains
+// collapse into literals and identical AND nodes are merged while building.
+class Aig{
+    private:
+        // DATA
+        vector<int>              d_fanin0;      // d_fanin0[n], d_fanin1[n] give the fanin literals of AND node n, -1 for leaves
+        vector<int>              d_fanin1;
+        vector<int>              d_leafVar;     // d_leafVar[n] gives the DIMACS variable of leaf n, 0 for AND nodes
+        vector<int>              d_wireLit;     // d_wireLit[v] gives the literal of DIMACS variable v
+        vector<int>              d_latchNode;   // Leaf of flip-flop output i
+        vector<int>              d_latchNext;   // Literal of PPO(t-1) feeding flip-flop output i
+        map<pair<int, int>, int> d_strash;      // (fanin0, fanin1) -> AND node
+        int                      d_numAnds;
+
+    public:
+        // CREATORS
+        Aig();
+
+        // MANIPULATORS
+        bool build        (Circuit&, int numVars);  // False if the circuit has a combinational loop
+
+        // ACCESSORS
+        int  numNodes     () const;
+        int  numAnds      () const;
+        int  numLatches   () const;
+        bool isAnd        (int node) const;
+        int  fanin0       (int node) const;
+        int  fanin1       (int node) const;
+        int  leafVar      (int node) const;
+        int  wireLit      (int cnfVar) const;
+        int  latchNode    (int i) const;
+        int  latchNext    (int i) const;
+
+        static int  node    (int lit) { return lit >> 1; }
+        static bool isCompl (int lit) { return lit & 1; }
+
+    private:
+        // Node construction with constant propagation and structural hashing
+        int  newLeaf      (int cnfVar);
+        int  mkAnd        (int, int);
+        int  mkOr         (int, int);
+        int  mkXor        (int, int);
+        int  mkMux        (int s, int a1, int a0);  // s ? a1 : a0
+        int  gateLit      (Gate::gateType, const vector<int>& inLits);
+        int  cellLit      (const CellLibrary&, int output, const vector<int>& inLits);
+};
+
+#endif
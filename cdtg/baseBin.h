@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include "coverVariable.h"
+#include "simulator.h"
 
 using namespace std;
 
@@ -20,16 +21,18 @@ class BaseBin{
         // MANIPULATORS
         virtual void    setSpec   (string*)=0;
         virtual void    setCnfVar (const int)=0;
-        virtual void    genCnf    (int*)=0;
+        virtual void    genCnf    (int*, bool positiveOnly)=0;  // positiveOnly: clauses of bin -> condition only
         virtual void    plusCount ()=0;
         
         // ACCESSORS
         virtual const string&       getName      () const=0;
         virtual const int&          getCnfVar    () const=0;
         virtual const int&          getHitCount  () const=0;
+        virtual const bool&         isExcluded   () const=0;
         virtual void                print        () const=0;
         virtual void                printClause  () const=0;
         virtual const vector<int>&  getCNFClause () const=0;
+        virtual SimWord             simHit       (const Simulator&, int word) const=0;  // Lanes of one word hitting the bin in the current frame
         
     protected:
       // DATA
@@ -40,6 +43,7 @@ class BaseBin{
       binType           d_type;
       int               d_hitCount;
       vector<int>       d_cnfClause;
+      bool              d_positiveOnly; // Set by genCnf(), definitions of auxiliary variables only keep the output -> inputs implications
 };
 
 #endif
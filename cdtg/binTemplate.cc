@@ -0,0 +1,167 @@
+#include "binTemplate.h"
+#include "coverGroup.h"
+#include "frameTemplate.h"
+#include "image.h"
+#include <assert.h>
+#include <limits.h>
+
+static inline Lit shiftLit(Lit p, int offset){
+  return mkLit(var(p) + offset, sign(p));
+}
+
+// CREATORS
+BinTemplate::BinTemplate(){
+  d_numVars = 0;
+}
+
+// MANIPULATORS
+void BinTemplate::capture(const vector<BaseBin*>& binList, int frameVar, int binVar){
+  int parsedLit, var;
+
+  clear();
+  d_binList = binList;
+  d_clauseBegin.push(0);
+  for(int i = 0; i < binList.size(); ++i){
+    const vector<int>& binClause = binList.at(i)->getCNFClause();
+    for(int j = 0; j < binClause.size(); ++j){
+      parsedLit = binClause.at(j);
+      if(parsedLit == 0){
+        d_clauseBegin.push(d_lits.size());
+        continue;
+      }
+      var = abs(parsedLit) - 1;
+      if(var >= binVar){
+        var -= binVar;
+        if(var >= d_numVars) d_numVars = var + 1;
+        d_binLit.push_back(1);
+      }
+      else{
+        // Bins only sample the covergroup bits of their own frame
+        assert(var >= frameVar);
+        var -= frameVar;
+        d_binLit.push_back(0);
+      }
+      d_lits.push( mkLit(var, parsedLit < 0) );
+    }
+  }
+  if(d_numVars < binList.size())
+    d_numVars = binList.size();
+}
+
+void BinTemplate::generate(CoverGroup* coverGroup_p, int numVars, bool positiveOnly){
+  vector<BaseBin*> binList;
+  int              cnfVar = numVars;
+
+  coverGroup_p->getBinList(&binList);
+  for(int i = 0; i < binList.size(); ++i)
+    binList.at(i)->setCnfVar(++cnfVar);
+  for(int i = 0; i < binList.size(); ++i)
+    binList.at(i)->genCnf(&cnfVar, positiveOnly);
+  capture(binList, 0, numVars);
+  coverGroup_p->resetBinCnf();
+}
+
+// Covergroup bits of a generate() template are circuit variables
+void BinTemplate::mapFrameVars(const FrameTemplate& frameTemplate){
+  int frameVar;
+
+  for(int i = 0; i < d_lits.size(); ++i)
+    if(!d_binLit[i]){
+      frameVar = frameTemplate.frameVar(var(d_lits[i]) + 1);
+      assert(frameVar >= 0); // Covergroup bits are roots of the frame
+      d_lits[i] = mkLit(frameVar, sign(d_lits[i]));
+    }
+}
+
+void BinTemplate::moveTo(BinTemplate* to_p){
+  to_p->clear();
+  to_p->d_binList.swap(d_binList);
+  to_p->d_numVars = d_numVars;
+  d_lits.moveTo(to_p->d_lits);
+  to_p->d_binLit.swap(d_binLit);
+  d_clauseBegin.moveTo(to_p->d_clauseBegin);
+  clear();
+}
+
+void BinTemplate::clear(){
+  d_binList.clear();
+  d_numVars = 0;
+  d_lits.clear();
+  d_binLit.clear();
+  d_clauseBegin.clear();
+}
+
+bool BinTemplate::readImage(const char** pos_p, const char* end, const CoverGroup& coverGroup){
+  vector<BaseBin*> binList;
+  vector<int>      info, lits, clauseBegin;
+  vector<char>     isBit;   // isBit[v] is set if DIMACS variable v is a covergroup bit
+
+  coverGroup.getBinList(&binList);
+  for(int i = 0; i < coverGroup.numOfVariable(); ++i)
+    for(int j = 0; j < coverGroup.getVariable(i)->getBitwidth(); ++j){
+      int bit = coverGroup.getVariable(i)->getCnfVar(j);
+      if(bit >= isBit.size())
+        isBit.resize(bit + 1, 0);
+      isBit[bit] = 1;
+    }
+  clear();
+  bool ok = readArray(pos_p, end, &info) && readArray(pos_p, end, &lits) &&
+            readArray(pos_p, end, &d_binLit) && readArray(pos_p, end, &clauseBegin);
+  ok = ok && info.size() == 2 && info[0] == binList.size() &&
+       d_binLit.size() == lits.size() && isCsr(clauseBegin, lits.size());
+  // Non-bin literals are covergroup bits, numVars is what capture() derives from the bin literals
+  int numVars = binList.size();
+  for(int i = 0; ok && i < lits.size(); ++i){
+    int v = var(toLit(lits[i]));
+    ok = lits[i] >= 0 && (d_binLit[i] == 1 || (d_binLit[i] == 0 && v + 1 < isBit.size() && isBit[v + 1]));
+    if(ok && d_binLit[i] == 1 && v >= numVars)
+      numVars = v + 1;
+    ok = ok && numVars <= binList.size() + lits.size();   // Auxiliary variables are dense
+  }
+  if(!ok || info[1] != numVars){
+    clear();
+    return false;
+  }
+  d_binList = binList;
+  d_numVars = info[1];
+  for(int i = 0; i < lits.size(); ++i)
+    d_lits.push( toLit(lits[i]) );
+  for(int i = 0; i < clauseBegin.size(); ++i)
+    d_clauseBegin.push(clauseBegin[i]);
+  return true;
+}
+
+// ACCESSORS
+bool BinTemplate::matches(const vector<BaseBin*>& binList) const{
+  return d_clauseBegin.size() > 0 && d_binList == binList;
+}
+
+int BinTemplate::numVars() const{
+  return d_numVars;
+}
+
+void BinTemplate::instantiate(Solver& solver, int frameVar) const{
+  const int binVar = solver.nVars();
+  vec<Lit>  lits;
+
+  solver.newVars(d_numVars);
+  lits.capacity(d_lits.size());
+  for(int i = 0; i < d_lits.size(); ++i)
+    lits.push( shiftLit(d_lits[i], d_binLit[i] ? binVar : frameVar) );
+  solver.addClauses(lits, d_clauseBegin);
+}
+
+void BinTemplate::writeImage(FILE* file) const{
+  vector<int> info, lits, clauseBegin;
+
+  info.push_back(d_binList.size());
+  info.push_back(d_numVars);
+  for(int i = 0; i < d_lits.size(); ++i)
+    lits.push_back( toInt(d_lits[i]) );
+  for(int i = 0; i < d_clauseBegin.size(); ++i)
+    clauseBegin.push_back(d_clauseBegin[i]);
+  writeArray(file, info);
+  writeArray(file, lits);
+  writeArray(file, d_binLit);
+  writeArray(file, clauseBegin);
+}
@@ -0,0 +1,61 @@
+#ifndef INCLUDED_BIN_TEMPLATE
+#define INCLUDED_BIN_TEMPLATE
+
+#include <vector>
+#include <stdio.h>
+#include "baseBin.h"
+
+#include "core/Solver.h"
+
+using namespace std;
+using namespace Minisat;
+
+class CoverGroup;
+class FrameTemplate;
+
+// CNF of a list of bins for one time frame, captured once from the clauses
+// generated by BaseBin::genCnf() and reused by later frames as long as the list
+// of bins stays the same.
+// The bin variables (one per bin, in list order) and the auxiliary variables of
+// their conditions follow the circuit variables of the frame, so literals are
+// stored relative either to the first variable of the frame (covergroup bits)
+// or to the first bin variable, and a new frame only shifts them.
+// generate() builds the template of all bins at the circuit variables before the
+// frame exists, the one DesignCache keeps with the covergroup; mapFrameVars() then
+// moves its covergroup bits to the frame.
+class BinTemplate{
+    private:
+        // DATA
+        vector<BaseBin*>  d_binList;      // Bins the template was captured for, in order
+        int               d_numVars;      // Bin and auxiliary variables
+        vec<Lit>          d_lits;         // Literals of all bin clauses, relative to the frame or to the first bin variable
+        vector<char>      d_binLit;       // d_binLit[i] is set if d_lits[i] is a bin or auxiliary variable
+        vec<int>          d_clauseBegin;  // Clause i is d_lits[d_clauseBegin[i]] ... d_lits[d_clauseBegin[i+1]-1]
+
+    public:
+        // CREATORS
+        BinTemplate();
+
+        // MANIPULATORS
+        // Capture the clauses of binList, generated for the frame starting at frameVar
+        // with bin variables starting at binVar
+        void capture     (const vector<BaseBin*>& binList, int frameVar, int binVar);
+        // Capture the clauses of CoverGroup::getBinList() with the covergroup bits at their
+        // circuit variables and bin variables following numVars, the bins are reset afterwards
+        void generate    (CoverGroup*, int numVars, bool positiveOnly);
+        void mapFrameVars(const FrameTemplate&);    // Move the covergroup bits of generate() to the frame variables
+        void moveTo      (BinTemplate*);    // Hand the template over, this one is left empty
+        void clear       ();
+        // Load writeImage() output for the bins of the covergroup, false if malformed
+        bool readImage   (const char** pos_p, const char* end, const CoverGroup&);
+
+        // ACCESSORS
+        bool matches     (const vector<BaseBin*>& binList) const;   // True if the template holds the CNF of binList
+        int  numVars     () const;
+        void writeImage  (FILE*) const;
+
+        // Add the bin clauses of the frame starting at frameVar, bin variables start at solver.nVars()
+        void instantiate (Solver&, int frameVar) const;
+};
+
+#endif
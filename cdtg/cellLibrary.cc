@@ -0,0 +1,338 @@
+#include "cellLibrary.h"
+#include "global.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+// Cells of common standard cell libraries beyond the built-in gate types
+static const char BUILTIN_CELLS[] =
+    "cell AND4    A B C D            : Y     = 8000 ;\n"
+    "cell OR4     A B C D            : Y     = FFFE ;\n"
+    "cell NOR4    A B C D            : Y     = 0001 ;\n"
+    "cell AOI22   A0 A1 B0 B1        : Y     = 0777 ;\n"
+    "cell OAI22   A0 A1 B0 B1        : Y     = 111F ;\n"
+    "cell AOI211  A0 A1 B0 C0        : Y     = 0007 ;\n"
+    "cell OAI211  A0 A1 B0 C0        : Y     = 1FFF ;\n"
+    "cell AOI31   A0 A1 A2 B0        : Y     = 007F ;\n"
+    "cell OAI31   A0 A1 A2 B0        : Y     = 01FF ;\n"
+    "cell AOI32   A0 A1 A2 B0 B1     : Y     = 007F7F7F ;\n"
+    "cell OAI32   A0 A1 A2 B0 B1     : Y     = 010101FF ;\n"
+    "cell AOI33   A0 A1 A2 B0 B1 B2  : Y     = 007F7F7F7F7F7F7F ;\n"
+    "cell OAI33   A0 A1 A2 B0 B1 B2  : Y     = 01010101010101FF ;\n"
+    "cell AOI221  A0 A1 B0 B1 C0     : Y     = 00000777 ;\n"
+    "cell OAI221  A0 A1 B0 B1 C0     : Y     = 111FFFFF ;\n"
+    "cell AOI222  A0 A1 B0 B1 C0 C1  : Y     = 0000077707770777 ;\n"
+    "cell OAI222  A0 A1 B0 B1 C0 C1  : Y     = 111F111F111FFFFF ;\n"
+    "cell XOR3    A B C              : Y     = 96 ;\n"
+    "cell XNOR3   A B C              : Y     = 69 ;\n"
+    "cell MXI2    A B S0             : Y     = 35 ;\n"
+    "cell MX4     A B C D S0 S1      : Y     = FF00F0F0CCCCAAAA ;\n"
+    "cell ADDH    A B                : S CO  = 6 8 ;\n"
+    "cell ADDF    A B CI             : S CO  = 96 E8 ;\n";
+
+static void libraryError(const char* source, const string& cell, const string& message){
+    cout << "Cell library " << source << ", cell " << cell << ": " << message << endl;
+    exit(1);
+}
+
+// Exact minimum cover of a minterm set by primes, ties go to fewer literals.
+// Starts from the greedy cover, which is kept if the search runs out of steps.
+struct CoverSearch{
+    vector<unsigned long long> sets;        // Minterms of prime i
+    vector<int>                literals;
+    vector<int>                current;
+    vector<int>                best;
+    int                        currentLiterals;
+    int                        bestLiterals;
+    long                       budget;
+
+    void greedy (unsigned long long set);
+    void run    (unsigned long long uncovered);
+};
+
+void CoverSearch::greedy(unsigned long long uncovered){
+    best.clear();
+    bestLiterals = 0;
+    while(uncovered != 0){
+        int pick = -1, gain = 0;
+        for(int i = 0; i < sets.size(); ++i){
+            int g = __builtin_popcountll(sets[i] & uncovered);
+            if(g > gain || (g == gain && g > 0 && literals[i] < literals[pick])){
+                pick = i;
+                gain = g;
+            }
+        }
+        best.push_back(pick);
+        bestLiterals += literals[pick];
+        uncovered &= ~sets[pick];
+    }
+}
+
+// Branches on the primes covering the lowest uncovered minterm
+void CoverSearch::run(unsigned long long uncovered){
+    if(uncovered == 0){
+        if(current.size() < best.size() || (current.size() == best.size() && currentLiterals < bestLiterals)){
+            best = current;
+            bestLiterals = currentLiterals;
+        }
+        return;
+    }
+    if(budget-- <= 0 || current.size() + 1 > best.size())
+        return;
+    int m = 0;
+    while(((uncovered >> m) & 1) == 0)
+        ++m;
+    for(int i = 0; i < sets.size(); ++i){
+        if(((sets[i] >> m) & 1) == 0)
+            continue;
+        current.push_back(i);
+        currentLiterals += literals[i];
+        run(uncovered & ~sets[i]);
+        currentLiterals -= literals[i];
+        current.pop_back();
+    }
+}
+
+// CREATORS
+CellLibrary::CellLibrary(){
+    Tokenizer tokenizer;
+
+    d_pinBegin.push_back(0);
+    d_outBegin.push_back(0);
+    d_cubeBegin.push_back(0);
+    d_cnfBegin.push_back(0);
+    d_signature = 14695981039346656037ULL;
+    tokenizer.attach(BUILTIN_CELLS, BUILTIN_CELLS + sizeof(BUILTIN_CELLS) - 1);
+    parse(tokenizer, "(built-in)");
+}
+
+// MANIPULATORS
+void CellLibrary::read(const char* fileName){
+    Tokenizer tokenizer;
+
+    if(!tokenizer.open(fileName)){
+        cout << "Cell library " << fileName << " could not be opened" << endl;
+        exit(1);
+    }
+    parse(tokenizer, fileName);
+}
+
+// ACCESSORS
+int CellLibrary::size() const{
+    return d_cellName.size();
+}
+
+int CellLibrary::findCell(const string& name) const{
+    map<string, int>::const_iterator it = d_cellMap.find(name);
+    return (it == d_cellMap.end()) ? -1 : it->second;
+}
+
+const string& CellLibrary::cellName(int cell) const{
+    return d_cellName.at(cell);
+}
+
+int CellLibrary::numInputs(int cell) const{
+    return d_numInputs.at(cell);
+}
+
+int CellLibrary::numOutputs(int cell) const{
+    return d_outBegin.at(cell + 1) - d_outBegin.at(cell);
+}
+
+int CellLibrary::findPin(int cell, const char* name, int length) const{
+    for(int i = d_pinBegin.at(cell); i < d_pinBegin.at(cell + 1); ++i)
+        if(d_pinName[i].length() == length && d_pinName[i].compare(0, length, name, length) == 0)
+            return i - d_pinBegin[cell];
+    return -1;
+}
+
+const string& CellLibrary::pinName(int cell, int pin) const{
+    return d_pinName.at(d_pinBegin.at(cell) + pin);
+}
+
+int CellLibrary::output(int cell, int k) const{
+    return d_outBegin.at(cell) + k;
+}
+
+unsigned long long CellLibrary::truthTable(int output) const{
+    return d_table.at(output);
+}
+
+int CellLibrary::coverSize(int output, bool onSet) const{
+    return d_cubeBegin.at(2 * output + onSet + 1) - d_cubeBegin.at(2 * output + onSet);
+}
+
+const CellLibrary::Cube* CellLibrary::getCover(int output, bool onSet) const{
+    return d_cube.empty() ? 0 : &d_cube[0] + d_cubeBegin.at(2 * output + onSet);
+}
+
+int CellLibrary::cnfSize(int cell) const{
+    return d_cnfBegin.at(cell + 1) - d_cnfBegin.at(cell);
+}
+
+const int* CellLibrary::getCNFClause(int cell) const{
+    return &d_cnf[0] + d_cnfBegin.at(cell);
+}
+
+unsigned long long CellLibrary::signature() const{
+    return d_signature;
+}
+
+// UTILITIES
+void CellLibrary::parse(Tokenizer& tokenizer, const char* source){
+    Tokenizer::Token           token;
+    string                     name;
+    vector<string>             pins;
+    vector<unsigned long long> tables;
+    int                        numInputs;
+
+    while(tokenizer.next(&token)){
+        if(!token.is("cell"))
+            libraryError(source, name, "expected 'cell' instead of " + token.toString());
+        if(!tokenizer.next(&token))
+            libraryError(source, name, "missing cell name");
+        name = token.toString();
+        pins.clear();
+        tables.clear();
+        while(tokenizer.next(&token) && !token.is(':'))
+            pins.push_back(token.toString());
+        numInputs = pins.size();
+        while(tokenizer.next(&token) && !token.is('='))
+            pins.push_back(token.toString());
+        while(tokenizer.next(&token) && !token.is(';')){
+            unsigned long long t = 0;
+            if(token.length > 16)
+                libraryError(source, name, "truth table " + token.toString() + " is longer than 64 bits");
+            for(int i = 0; i < token.length; ++i){
+                char c = token.str[i];
+                int  d = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 :
+                         (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+                if(d < 0)
+                    libraryError(source, name, "truth table " + token.toString() + " is not hexadecimal");
+                t = (t << 4) | d;
+            }
+            tables.push_back(t);
+        }
+        if(!token.is(';'))
+            libraryError(source, name, "missing ';'");
+
+        int numOutputs = pins.size() - numInputs;
+        if(numInputs > MAX_INPUTS)
+            libraryError(source, name, "more than " + Global::int2str(MAX_INPUTS) + " inputs");
+        if(numOutputs < 1 || numOutputs > MAX_OUTPUTS)
+            libraryError(source, name, "needs 1 to " + Global::int2str(MAX_OUTPUTS) + " outputs");
+        if(tables.size() != numOutputs)
+            libraryError(source, name, "needs one truth table per output");
+        for(int i = 0; i < tables.size(); ++i)
+            if(numInputs < MAX_INPUTS && (tables[i] >> (1 << numInputs)) != 0)
+                libraryError(source, name, "truth table has more than 2^inputs bits");
+        for(int i = 0; i < pins.size(); ++i)
+            for(int j = 0; j < i; ++j)
+                if(pins[i] == pins[j])
+                    libraryError(source, name, "pin " + pins[i] + " is declared twice");
+        addCell(name, pins, numInputs, tables);
+    }
+}
+
+void CellLibrary::addCell(const string& name, const vector<string>& pins, int numInputs,
+                          const vector<unsigned long long>& tables){
+    int cell = d_cellName.size();
+
+    d_cellName.push_back(name);
+    d_cellMap[name] = cell;
+    d_pinName.insert(d_pinName.end(), pins.begin(), pins.end());
+    d_pinBegin.push_back(d_pinName.size());
+    d_numInputs.push_back(numInputs);
+    mix(&d_signature, name.c_str(), name.length() + 1);
+    for(int i = 0; i < pins.size(); ++i)
+        mix(&d_signature, pins[i].c_str(), pins[i].length() + 1);
+    mix(&d_signature, &numInputs, sizeof(numInputs));
+
+    unsigned long long all = (numInputs == MAX_INPUTS) ? ~0ULL : (1ULL << (1 << numInputs)) - 1;
+    for(int k = 0; k < tables.size(); ++k){
+        int output = d_table.size();
+        d_table.push_back(tables[k]);
+        mix(&d_signature, &tables[k], sizeof(tables[k]));
+        addCover(all & ~tables[k], numInputs);
+        addCover(tables[k], numInputs);
+
+        // Off-set cubes force Y to 0, on-set cubes force Y to 1
+        int y = numInputs + k + 1;
+        for(int onSet = 0; onSet < 2; ++onSet){
+            for(int c = 0; c < coverSize(output, onSet); ++c){
+                const Cube& cube = getCover(output, onSet)[c];
+                for(int i = 0; i < numInputs; ++i)
+                    if((cube.mask >> i) & 1)
+                        d_cnf.push_back(((cube.value >> i) & 1) ? -(i + 1) : i + 1);
+                d_cnf.push_back(onSet ? y : -y);
+                d_cnf.push_back(0);
+            }
+        }
+    }
+    d_outBegin.push_back(d_table.size());
+    d_cnfBegin.push_back(d_cnf.size());
+}
+
+// Appends a minimum cover of set by its prime implicants
+void CellLibrary::addCover(unsigned long long set, int numInputs){
+    vector<Cube> primes;
+    CoverSearch  search;
+
+    findPrimes(set, numInputs, &primes);
+    for(int i = 0; i < primes.size(); ++i){
+        search.sets.push_back(cubeSet(primes[i], numInputs));
+        search.literals.push_back(__builtin_popcount(primes[i].mask));
+    }
+    search.greedy(set);
+    search.currentLiterals = 0;
+    search.budget = 100000;
+    search.run(set);
+    for(int i = 0; i < search.best.size(); ++i)
+        d_cube.push_back(primes[search.best[i]]);
+    d_cubeBegin.push_back(d_cube.size());
+}
+
+// All 3^n cubes are tried, an implicant is prime if dropping any literal leaves the set
+void CellLibrary::findPrimes(unsigned long long set, int numInputs, vector<Cube>* primes_p){
+    int full = (1 << numInputs) - 1;
+    for(int mask = 0; mask <= full; ++mask){
+        for(int value = mask; ; value = (value - 1) & mask){
+            Cube cube;
+            cube.mask  = mask;
+            cube.value = value;
+            unsigned long long minterms = cubeSet(cube, numInputs);
+            if((minterms & ~set) == 0){
+                bool prime = true;
+                for(int i = 0; i < numInputs && prime; ++i){
+                    if(((mask >> i) & 1) == 0)
+                        continue;
+                    Cube larger;
+                    larger.mask  = mask & ~(1 << i);
+                    larger.value = value & ~(1 << i);
+                    prime = (cubeSet(larger, numInputs) & ~set) != 0;
+                }
+                if(prime)
+                    primes_p->push_back(cube);
+            }
+            if(value == 0)
+                break;
+        }
+    }
+}
+
+unsigned long long CellLibrary::cubeSet(const Cube& cube, int numInputs){
+    unsigned long long minterms = 0;
+    for(int m = 0; m < (1 << numInputs); ++m)
+        if((m & cube.mask) == cube.value)
+            minterms |= 1ULL << m;
+    return minterms;
+}
+
+// FNV-1a
+void CellLibrary::mix(unsigned long long* hash_p, const void* data, int length){
+    const unsigned char* p = (const unsigned char*)data;
+    for(int i = 0; i < length; ++i){
+        *hash_p ^= p[i];
+        *hash_p *= 1099511628211ULL;
+    }
+}
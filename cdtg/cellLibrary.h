@@ -0,0 +1,82 @@
+#ifndef INCLUDED_CELL_LIBRARY
+#define INCLUDED_CELL_LIBRARY
+
+#include <string>
+#include <vector>
+#include <map>
+#include "tokenizer.h"
+
+using namespace std;
+
+// Logic cells described by pin names and one truth table per output, for cells
+// that have no Gate::gateType of their own (AND4, AOI22, MX4, full adders, ...).
+// A library file is a list of statements
+//     cell NAME INPUT ... : OUTPUT ... = TABLE ... ;
+// where TABLE is hexadecimal and bit m of it is the output for the input
+// assignment m, the first input being the least significant bit of m.
+//
+// The CNF of an output is built once per cell from minimum covers of prime
+// implicants: each cube of the on-set gives the clause (!cube | Y), each cube of
+// the off-set the clause (!cube | !Y). All outputs of a multi-output cell share
+// the input pins and go into one clause template, so a gate is encoded by pin
+// substitution without auxiliary variables.
+// Pins are numbered inputs first (0 ... numInputs-1), then outputs.
+class CellLibrary{
+    public:
+        enum {MAX_INPUTS = 6, MAX_OUTPUTS = 8};   // Truth tables are 64 bits
+
+        struct Cube{
+          unsigned char mask;    // Input i is a literal of the cube if bit i is set,
+          unsigned char value;   // positive if bit i of value is set
+        };
+
+    private:
+        // DATA
+        vector<string>              d_cellName;
+        map<string, int>            d_cellMap;      // A later definition of a name replaces the earlier one
+        vector<int>                 d_pinBegin;     // Pins of cell c are d_pinName[d_pinBegin[c]] ... d_pinName[d_pinBegin[c+1]-1]
+        vector<string>              d_pinName;
+        vector<int>                 d_numInputs;
+        vector<int>                 d_outBegin;     // Outputs of cell c are d_outBegin[c] ... d_outBegin[c+1]-1
+        vector<unsigned long long>  d_table;        // Truth table of output o
+        vector<int>                 d_cubeBegin;    // Cover of output o is d_cube[d_cubeBegin[2o+p]] ... d_cube[d_cubeBegin[2o+p+1]-1], p = 1 for the on-set
+        vector<Cube>                d_cube;
+        vector<int>                 d_cnfBegin;     // Clauses of cell c over literals +-(pin+1), end with 0
+        vector<int>                 d_cnf;
+        unsigned long long          d_signature;
+
+    public:
+        // CREATORS
+        CellLibrary();                              // Built-in cells
+
+        // MANIPULATORS
+        void read        (const char* fileName);    // Adds the cells of a library file, exits on errors
+
+        // ACCESSORS
+        int         size        () const;
+        int         findCell    (const string& name) const;                    // -1 if no such cell
+        const string& cellName  (int cell) const;
+        int         numInputs   (int cell) const;
+        int         numOutputs  (int cell) const;
+        int         findPin     (int cell, const char* name, int length) const;  // -1 if no such pin
+        const string& pinName   (int cell, int pin) const;
+        int         output      (int cell, int k) const;                       // Library-wide index of output k
+        unsigned long long truthTable (int output) const;
+        int         coverSize   (int output, bool onSet) const;
+        const Cube* getCover    (int output, bool onSet) const;
+        int         cnfSize     (int cell) const;                              // Number of literals and clause ending 0s
+        const int*  getCNFClause(int cell) const;
+        unsigned long long signature () const;                                 // Hash of all cell definitions
+
+    private:
+        void        parse       (Tokenizer&, const char* source);
+        void        addCell     (const string& name, const vector<string>& pins, int numInputs,
+                                 const vector<unsigned long long>& tables);
+        void        addCover    (unsigned long long set, int numInputs);
+
+        static void findPrimes    (unsigned long long set, int numInputs, vector<Cube>* primes_p);
+        static unsigned long long cubeSet (const Cube&, int numInputs);
+        static void mix           (unsigned long long* hash_p, const void* data, int length);
+};
+
+#endif
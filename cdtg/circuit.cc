@@ -1,57 +1,138 @@
 #include "circuit.h"
+#include "image.h"
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 
 // CREATORS
-Circuit::Circuit(){}
-
-Circuit::~Circuit(){
-    for(int i=0;i<d_gateList.size();++i)
-        delete d_gateList.at(i);
-    for(int i=0;i<d_wireList.size();++i)
-        delete d_wireList.at(i);
+Circuit::Circuit(){
+    d_library_p = NULL;
+    d_inBegin.push_back(0);
+    d_outBegin.push_back(0);
+    d_cnfBegin.push_back(0);
 }
 
 // MANIPULATORS
-void Circuit::addGate(Gate* gate_p){
-    d_gateList.push_back(gate_p);
-  
-    if(gate_p->getType() == Gate::DFF)
-        d_dffList.push_back(gate_p);
+int Circuit::addWire(const string& name, Wire::wireType type, int cnfVar){
+    return addWire(name.data(), name.length(), type, cnfVar);
+}
+
+int Circuit::addWire(const char* name, int length, Wire::wireType type, int cnfVar){
+    d_nameBegin.push_back(d_namePool.size());
+    d_namePool.insert(d_namePool.end(), name, name + length);
+    d_namePool.push_back('\0');
+    d_nameHash.push_back(hashName(name, length));
+    d_wireType.push_back(type);
+    d_wireCnfVar.push_back(cnfVar);
+    d_wireSource.push_back(-1);
+    insertSymbol(d_wireType.size() - 1);
+    return d_wireType.size() - 1;
+}
+
+// The first wire of a name is kept if the name is declared again
+void Circuit::insertSymbol(int wire){
+    const char* name = getWireName(wire);
+    if(findWire(name, strlen(name)) >= 0)
+        return;
+    // Grow to keep the load factor below 1/2
+    if(2 * wireListSize() > (int)d_symbolTable.size()){
+        vector<int> old;
+        old.swap(d_symbolTable);
+        d_symbolTable.assign(old.empty() ? 1024 : 2 * old.size(), -1);
+        for(int i = 0; i < old.size(); ++i)
+            if(old[i] >= 0)
+                placeSymbol(old[i]);
+    }
+    placeSymbol(wire);
+}
+
+void Circuit::placeSymbol(int wire){
+    unsigned mask = d_symbolTable.size() - 1;
+    unsigned slot = d_nameHash[wire] & mask;
+    while(d_symbolTable[slot] >= 0)
+        slot = (slot + 1) & mask;
+    d_symbolTable[slot] = wire;
+}
+
+// FNV-1a
+unsigned Circuit::hashName(const char* name, int length){
+    unsigned h = 2166136261u;
+    for(int i = 0; i < length; ++i){
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void Circuit::setWireType(int wire, Wire::wireType type){
+    d_wireType.at(wire) = type;
+}
+
+void Circuit::setLibrary(const CellLibrary* library_p){
+    d_library_p = library_p;
+}
+
+int Circuit::addGate(Gate::gateType type, int cell){
+    d_gateType.push_back(type);
+    d_gateCell.push_back((type == Gate::CELL) ? cell : -1);
+    d_inBegin.push_back(d_in.size());
+    d_outBegin.push_back(d_out.size());
+    if(type == Gate::DFF)
+        d_dffList.push_back(d_gateType.size() - 1);
+    return d_gateType.size() - 1;
+}
+
+void Circuit::addInWire(int wire){
+    d_in.push_back(wire);
+    ++d_inBegin.back();
 }
 
-void Circuit::addWire(Wire* wire_p){
-    d_wireList.push_back(wire_p);
+void Circuit::addOutWire(int wire, char port){
+    d_out.push_back(wire);
+    d_outPort.push_back(port);
+    ++d_outBegin.back();
+    d_wireSource.at(wire) = d_gateType.size() - 1;
 }
 
 void Circuit::classifyWire(){
     // Add special type of wires to specific list
-    for(int i = 0; i < d_wireList.size(); ++i){
-        switch(d_wireList.at(i)->getType()){
+    for(int i = 0; i < d_wireType.size(); ++i){
+        switch(d_wireType[i]){
             case Wire::PI:
-                d_piList.push_back(d_wireList.at(i));
-                d_str2PI[d_wireList.at(i)->getName()] = d_wireList.at(i);
+                d_piList.push_back(i);
                 break;
             case Wire::PO:
-                d_poList.push_back(d_wireList.at(i));
+                d_poList.push_back(i);
                 break;
             case Wire::PPI:
-                d_ppiList.push_back(d_wireList.at(i));
+                d_ppiList.push_back(i);
                 break;
             case Wire::PPO:
-                d_ppoList.push_back(d_wireList.at(i));
-                d_str2PPO[d_wireList.at(i)->getName()] = d_wireList.at(i);
+                d_ppoList.push_back(i);
                 break;
             case Wire::CLK:
-                d_clkList.push_back(d_wireList.at(i));
+                d_clkList.push_back(i);
                 break;
             case Wire::RST:
-                d_rstList.push_back(d_wireList.at(i));
+                d_rstList.push_back(i);
                 break;
             case Wire::NORMAL:
                 break;
       }
     }
+    
+    // Fanout arrays, gates reading a wire are kept in gate order
+    d_fanoutBegin.assign(d_wireType.size() + 1, 0);
+    for(int k = 0; k < d_in.size(); ++k)
+        ++d_fanoutBegin[d_in[k] + 1];
+    for(int w = 0; w < d_wireType.size(); ++w)
+        d_fanoutBegin[w + 1] += d_fanoutBegin[w];
+    d_fanout.resize(d_in.size());
+    vector<int> fill(d_fanoutBegin.begin(), d_fanoutBegin.end() - 1);
+    for(int g = 0; g < d_gateType.size(); ++g)
+        for(int k = d_inBegin[g]; k < d_inBegin[g + 1]; ++k)
+            d_fanout[fill[d_in[k]]++] = g;
 }
 
 void Circuit::setName(string name){
@@ -63,360 +144,584 @@ string Circuit::getName(){
     return d_name;
 }
 
-Gate* Circuit::getGate(int idx){
-    return d_gateList.at(idx);
+const CellLibrary* Circuit::getLibrary() const{
+    return d_library_p;
 }
 
-Gate* Circuit::getDFF(int idx){
-    return d_dffList.at(idx);
+// Wires
+int Circuit::findWire(const char* name, int length) const{
+    if(d_symbolTable.empty())
+        return -1;
+    unsigned h    = hashName(name, length);
+    unsigned slot = h & (d_symbolTable.size() - 1);
+    for(int w; (w = d_symbolTable[slot]) >= 0; slot = (slot + 1) & (d_symbolTable.size() - 1))
+        if(d_nameHash[w] == h && strncmp(getWireName(w), name, length) == 0 && getWireName(w)[length] == '\0')
+            return w;
+    return -1;
+}
+
+int Circuit::findWire(const string& name) const{
+    return findWire(name.data(), name.length());
+}
+
+const char* Circuit::getWireName(int wire) const{
+    return &d_namePool[d_nameBegin.at(wire)];
+}
+
+Wire::wireType Circuit::getWireType(int wire) const{
+    return (Wire::wireType)d_wireType.at(wire);
+}
+
+int Circuit::getCnfVar(int wire) const{
+    return d_wireCnfVar.at(wire);
+}
+
+int Circuit::getSourceGate(int wire) const{
+    return d_wireSource.at(wire);
+}
+
+int Circuit::fanoutSize(int wire) const{
+    return d_fanoutBegin.at(wire + 1) - d_fanoutBegin.at(wire);
+}
+
+int Circuit::getDestGate(int wire, int i) const{
+    return d_fanout.at(d_fanoutBegin.at(wire) + i);
 }
 
-Wire* Circuit::getWire(int idx){
-    return d_wireList.at(idx);
+// Gates
+Gate::gateType Circuit::getGateType(int gate) const{
+    return (Gate::gateType)d_gateType.at(gate);
 }
 
-Wire* Circuit::getPI(int idx){
+int Circuit::inputSize(int gate) const{
+    return d_inBegin.at(gate + 1) - d_inBegin.at(gate);
+}
+
+int Circuit::outputSize(int gate) const{
+    return d_outBegin.at(gate + 1) - d_outBegin.at(gate);
+}
+
+int Circuit::getInWire(int gate, int i) const{
+    return d_in.at(d_inBegin.at(gate) + i);
+}
+
+int Circuit::getOutWire(int gate, int i) const{
+    return d_out.at(d_outBegin.at(gate) + i);
+}
+
+char Circuit::getPort(int gate, int i) const{
+    return d_outPort.at(d_outBegin.at(gate) + i);
+}
+
+int Circuit::getCell(int gate) const{
+    return d_gateCell.at(gate);
+}
+
+int Circuit::cnfSize(int gate) const{
+    return d_cnfBegin.at(gate + 1) - d_cnfBegin.at(gate);
+}
+
+const int* Circuit::getCNFClause(int gate) const{
+    return d_cnf.empty() ? 0 : &d_cnf[d_cnfBegin.at(gate)];
+}
+
+// Special gates and wires
+int Circuit::getDFF(int idx) const{
+    return d_dffList.at(idx);
+}
+
+int Circuit::getPI(int idx) const{
     return d_piList.at(idx);
 }
 
-Wire* Circuit::getPI(string name){
-    return d_str2PI.find(name)->second;
+int Circuit::getPI(string name) const{
+    int wire = findWire(name);
+    return (wire >= 0 && getWireType(wire) == Wire::PI) ? wire : -1;
 }
 
-Wire* Circuit::getPO(int idx){
+int Circuit::getPO(int idx) const{
     return d_poList.at(idx);
 }
 
-Wire* Circuit::getPPI(int idx){
+int Circuit::getPPI(int idx) const{
     return d_ppiList.at(idx);
 }
 
-Wire* Circuit::getPPO(int idx){
+int Circuit::getPPO(int idx) const{
     return d_ppoList.at(idx);
 }
 
-Wire* Circuit::getPPO(string name){
-    return d_str2PPO.find(name)->second;
+int Circuit::getPPO(string name) const{
+    int wire = findWire(name);
+    return (wire >= 0 && getWireType(wire) == Wire::PPO) ? wire : -1;
 }
 
-Wire* Circuit::getCLK(int idx){
+int Circuit::getCLK(int idx) const{
     return d_clkList.at(idx);
 }
 
-Wire* Circuit::getRST(int idx){
+int Circuit::getRST(int idx) const{
     return d_rstList.at(idx);
 }
 
-int Circuit::gateListSize(){
-    return d_gateList.size();
+int Circuit::gateListSize() const{
+    return d_gateType.size();
 }
 
-int Circuit::dffListSize(){
+int Circuit::dffListSize() const{
     return d_dffList.size();
 }
 
-int Circuit::wireListSize(){
-    return d_wireList.size();
+int Circuit::wireListSize() const{
+    return d_wireType.size();
 }
 
-int Circuit::PIListSize(){
+int Circuit::PIListSize() const{
     return d_piList.size();
 }
 
-int Circuit::POListSize(){
+int Circuit::POListSize() const{
     return d_poList.size();
 }
 
-int Circuit::PPIListSize(){
+int Circuit::PPIListSize() const{
     return d_ppiList.size();
 }
 
-int Circuit::PPOListSize(){
+int Circuit::PPOListSize() const{
     return d_ppoList.size();
 }
 
-int Circuit::CLKListSize(){
+int Circuit::CLKListSize() const{
     return d_clkList.size();
 }
 
-int Circuit::RSTListSize(){
+int Circuit::RSTListSize() const{
     return d_rstList.size();
 }
 
 // Print functions
 void Circuit::printWireInfo(){
   cout << "\n================ Wire Information ================\n" << endl;
-  for(int i=0;i<d_wireList.size();++i){
-    cout << "Wire: " << d_wireList.at(i)->getName() << endl;
-    d_wireList.at(i)->printType();
-    //cout << "  CNF variable number = " << d_wireList.at(i)->getCnfVar() << endl;
-    if(d_wireList.at(i)->getSourceGate() != NULL){
+  for(int i = 0; i < wireListSize(); ++i){
+    cout << "Wire: " << getWireName(i) << endl;
+    Wire::printType(getWireType(i));
+    if(getSourceGate(i) >= 0){
       cout << "  Source gate = "; 
-      d_wireList.at(i)->getSourceGate()->printType();
+      Gate::printType(getGateType(getSourceGate(i)));
       cout << endl;
     }
     else
       cout << "  Source gate = NULL" << endl;
-    if(d_wireList.at(i)->fanoutSize()!= 0)
-      for(int j=0;j<d_wireList.at(i)->fanoutSize();++j){
+    if(fanoutSize(i) != 0)
+      for(int j = 0; j < fanoutSize(i); ++j){
         cout << "  Destination gate = ";
-        d_wireList.at(i)->getDestGate(j)->printType(); 
+        Gate::printType(getGateType(getDestGate(i, j))); 
         cout << endl;
       }
     else
       cout << "  Destination gate = NULL" << endl;
-      
-    //if(d_wireList.at(i)->getType()==Wire::PI){
-      //cout << "Wire: " << d_wireList.at(i)->getName() << endl;
-      //d_wireList.at(i)->printType();
-      cout << "  CNF variable number = " << d_wireList.at(i)->getCnfVar() << endl;
-    //}
-   /* 
-    // Identify count register
-    if(d_wireList.at(i)->getType()==Wire::PPI){
-      string name = d_wireList.at(i)->getName();
-      if(name.substr(0,5).compare("count")==0){
-        cout << "Wire: " << d_wireList.at(i)->getName() << endl;
-        d_wireList.at(i)->printType();
-        cout << "  CNF variable number = " << d_wireList.at(i)->getCnfVar() << endl;
-      }
-    }*/
-    
+    cout << "  CNF variable number = " << getCnfVar(i) << endl;
   }// End for
 }
 
 void Circuit::printGateInfo(){
   cout << "\n================ Gate Information ================\n" << endl;
-  for(int i = 0; i < d_gateList.size(); ++i){
+  for(int i = 0; i < gateListSize(); ++i){
     cout << "Gate: "; 
-    d_gateList.at(i)->printType(); 
+    Gate::printType(getGateType(i)); 
+    if(getGateType(i) == Gate::CELL)
+      cout << d_library_p->cellName(getCell(i));
     cout << endl;
-//    cout << "Original string: " << d_gateList.at(i)->getUtilityStr() << endl;
-      for(int j = 0; j < d_gateList.at(i)->outputSize(); ++j){
-        cout << "  Output wire = " << d_gateList.at(i)->getOutWire(j)->getName();
-        if(d_gateList.at(i)->getType() == Gate::DFF){
+      for(int j = 0; j < outputSize(i); ++j){
+        cout << "  Output wire = " << getWireName(getOutWire(i, j));
+        if(getGateType(i) == Gate::DFF){
         	cout << ", port type = ";
-        	if(d_gateList.at(i)->getDFFPort(j) == 'Q')
+        	if(getPort(i, j) == 'Q')
         		cout << "Q";
-        	else if(d_gateList.at(i)->getDFFPort(j) == 'N')
+        	else if(getPort(i, j) == 'N')
         		cout << "QN";
         }
         cout << endl;
       }
-      for(int j = 0; j < d_gateList.at(i)->inputSize(); ++j)
-        cout << "  Input wire = "  << d_gateList.at(i)->getInWire(j)->getName() << endl;
+      for(int j = 0; j < inputSize(i); ++j)
+        cout << "  Input wire = "  << getWireName(getInWire(i, j)) << endl;
+  }
+}
+
+void Circuit::writeImage(FILE* file) const{
+  vector<char> name(d_name.begin(), d_name.end());
+  writeArray(file, name);
+  writeArray(file, d_namePool);
+  writeArray(file, d_nameBegin);
+  writeArray(file, d_nameHash);
+  writeArray(file, d_symbolTable);
+  writeArray(file, d_wireType);
+  writeArray(file, d_wireCnfVar);
+  writeArray(file, d_wireSource);
+  writeArray(file, d_fanoutBegin);
+  writeArray(file, d_fanout);
+  writeArray(file, d_gateType);
+  writeArray(file, d_inBegin);
+  writeArray(file, d_in);
+  writeArray(file, d_outBegin);
+  writeArray(file, d_out);
+  writeArray(file, d_outPort);
+  writeArray(file, d_gateCell);
+  writeArray(file, d_cnfBegin);
+  writeArray(file, d_cnf);
+  writeArray(file, d_dffList);
+  writeArray(file, d_piList);
+  writeArray(file, d_poList);
+  writeArray(file, d_ppiList);
+  writeArray(file, d_ppoList);
+  writeArray(file, d_clkList);
+  writeArray(file, d_rstList);
+}
+
+bool Circuit::readImage(const char* begin, const char* end, int numVars){
+  vector<char> name;
+  const char*  pos = begin;
+  bool ok = readArray(&pos, end, &name)          && readArray(&pos, end, &d_namePool)   &&
+            readArray(&pos, end, &d_nameBegin)   && readArray(&pos, end, &d_nameHash)   &&
+            readArray(&pos, end, &d_symbolTable) && readArray(&pos, end, &d_wireType)   &&
+            readArray(&pos, end, &d_wireCnfVar)  && readArray(&pos, end, &d_wireSource) &&
+            readArray(&pos, end, &d_fanoutBegin) && readArray(&pos, end, &d_fanout)     &&
+            readArray(&pos, end, &d_gateType)    && readArray(&pos, end, &d_inBegin)    &&
+            readArray(&pos, end, &d_in)          && readArray(&pos, end, &d_outBegin)   &&
+            readArray(&pos, end, &d_out)         && readArray(&pos, end, &d_outPort)    &&
+            readArray(&pos, end, &d_gateCell)    &&
+            readArray(&pos, end, &d_cnfBegin)    && readArray(&pos, end, &d_cnf)        &&
+            readArray(&pos, end, &d_dffList)     && readArray(&pos, end, &d_piList)     &&
+            readArray(&pos, end, &d_poList)      && readArray(&pos, end, &d_ppiList)    &&
+            readArray(&pos, end, &d_ppoList)     && readArray(&pos, end, &d_clkList)    &&
+            readArray(&pos, end, &d_rstList);
+  // Sizes of the parallel arrays must agree
+  int numWires = d_wireType.size();
+  int numGates = d_gateType.size();
+  ok = ok && pos == end &&
+       d_nameBegin.size() == numWires && d_nameHash.size() == numWires && d_wireCnfVar.size() == numWires &&
+       d_wireSource.size() == numWires && d_fanoutBegin.size() == numWires + 1 &&
+       d_inBegin.size() == numGates + 1 && d_outBegin.size() == numGates + 1 && d_cnfBegin.size() == numGates + 1 &&
+       d_outPort.size() == d_out.size() && d_gateCell.size() == numGates;
+  // Every index must point into its array, the image may come from a damaged or foreign file
+  ok = ok && isCsr(d_fanoutBegin, d_fanout.size()) && isCsr(d_inBegin, d_in.size()) &&
+       isCsr(d_outBegin, d_out.size()) && isCsr(d_cnfBegin, d_cnf.size()) &&
+       inRange(d_fanout, 0, numGates) && inRange(d_in, 0, numWires) && inRange(d_out, 0, numWires) &&
+       inRange(d_wireSource, -1, numGates) && inRange(d_wireCnfVar, 0, numVars + 1) &&
+       inRange(d_dffList, 0, numGates) && inRange(d_piList, 0, numWires) && inRange(d_poList, 0, numWires) &&
+       inRange(d_ppiList, 0, numWires) && inRange(d_ppoList, 0, numWires) &&
+       inRange(d_clkList, 0, numWires) && inRange(d_rstList, 0, numWires) &&
+       inRange(d_nameBegin, 0, d_namePool.size()) && inRange(d_symbolTable, -1, numWires) &&
+       (d_namePool.empty() || d_namePool.back() == '\0');
+  // Symbol table: a power of two with an empty slot ending every probe
+  ok = ok && (d_symbolTable.size() & (d_symbolTable.size() - 1)) == 0 &&
+       (d_symbolTable.empty() || count(d_symbolTable.begin(), d_symbolTable.end(), -1) > 0);
+  // Stored hashes must match the names, a stale one would make lookups miss
+  for(int w = 0; ok && w < numWires; ++w)
+    ok = d_wireType[w] >= Wire::PI && d_wireType[w] <= Wire::RST &&
+         d_nameHash[w] == hashName(getWireName(w), strlen(getWireName(w)));
+  // Clause literals are variables of the image, clauses end with 0
+  for(int i = 0; ok && i < d_cnf.size(); ++i)
+    ok = d_cnf[i] >= -numVars && d_cnf[i] <= numVars;
+  // Gates must have the pins their CNF, AIG and simulation read, in Gate::gateType order
+  static const int minInputs [Gate::UNKNOWN] = {1, 1, 2, 3, 2, 3, 2, 3, 4, 3, 3, 2, 3, 2, 2, 3, 1, 0, 1, 0, 0, 0};
+  static const int minOutputs[Gate::UNKNOWN] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 1, 0};
+  for(int g = 0; ok && g < numGates; ++g){
+    int type = d_gateType[g];
+    ok = type >= Gate::BUF && type < Gate::UNKNOWN;
+    ok = ok && inputSize(g) >= minInputs[type] && outputSize(g) >= minOutputs[type] &&
+         (d_cnfBegin[g] == d_cnfBegin[g + 1] || d_cnf[d_cnfBegin[g + 1] - 1] == 0);
+    // Cells must come from the library the image was built with, pins and ports must fit the cell
+    if(ok && d_gateCell[g] >= 0){
+      int cell = d_gateCell[g];
+      ok = d_gateType[g] == Gate::CELL && d_library_p != NULL && cell < d_library_p->size() &&
+           inputSize(g) == d_library_p->numInputs(cell);
+      for(int k = 0; ok && k < outputSize(g); ++k)
+        ok = getPort(g, k) >= '0' && getPort(g, k) - '0' < d_library_p->numOutputs(cell);
+    }
+    else if(ok)
+      ok = d_gateType[g] != Gate::CELL;
+  }
+  if(!ok){
+    const CellLibrary* library_p = d_library_p;
+    *this = Circuit();
+    d_library_p = library_p;
+    return false;
   }
+  d_name.assign(name.begin(), name.end());
+  return true;
 }
 
 // For CNF initialization
 void Circuit::setCNF(){
-  Gate::gateType type;
-  Gate* gate_p;
-  for(int i = 0; i < d_gateList.size(); ++i){
-    gate_p = d_gateList.at(i);
-    //cout << "Generating CNF of gate: " << gate_p->getUtilityStr() << endl;
-    type = gate_p->getType();
-    switch(type){
-    	case Gate::BUF:    genBUFCNF(gate_p);    break;
-    	case Gate::INV:    genINVCNF(gate_p);    break;
-    	case Gate::AND2:   genAND2CNF(gate_p);   break;
-    	case Gate::AND3:   genAND3CNF(gate_p);   break;
-    	case Gate::OR2:    genOR2CNF(gate_p);    break;
-    	case Gate::OR3:    genOR3CNF(gate_p);    break;
-    	case Gate::NAND2:  genNAND2CNF(gate_p);  break;
-    	case Gate::NAND3:  genNAND3CNF(gate_p);  break;
-    	case Gate::NAND4:  genNAND4CNF(gate_p);  break;
-    	case Gate::NOR2:   genNOR2CNF(gate_p);   break;
-    	case Gate::NOR3:   genNOR3CNF(gate_p);   break;
-    	case Gate::XOR2:   genXOR2CNF(gate_p);   break;
-    	case Gate::XNOR2:  genXNOR2CNF(gate_p);  break;
-    	case Gate::MX2:    genMX2CNF(gate_p);    break;
-    	case Gate::OAI21:  genOAI21CNF(gate_p);  break;
-    	case Gate::AOI21:  genAOI21CNF(gate_p);  break;
-    	case Gate::CONST0: genCONST0CNF(gate_p); break;
-    	case Gate::CONST1: genCONST1CNF(gate_p); break;
-    	case Gate::DFF:                          break;
-    	case Gate::INPUT:                        break;
-    	case Gate::OUTPUT:                       break;
+  d_cnf.clear();
+  d_cnfBegin.assign(1, 0);
+  for(int gate = 0; gate < gateListSize(); ++gate){
+    switch(getGateType(gate)){
+    	case Gate::BUF:    genBUFCNF(gate);    break;
+    	case Gate::INV:    genINVCNF(gate);    break;
+    	case Gate::AND2:   genAND2CNF(gate);   break;
+    	case Gate::AND3:   genAND3CNF(gate);   break;
+    	case Gate::OR2:    genOR2CNF(gate);    break;
+    	case Gate::OR3:    genOR3CNF(gate);    break;
+    	case Gate::NAND2:  genNAND2CNF(gate);  break;
+    	case Gate::NAND3:  genNAND3CNF(gate);  break;
+    	case Gate::NAND4:  genNAND4CNF(gate);  break;
+    	case Gate::NOR2:   genNOR2CNF(gate);   break;
+    	case Gate::NOR3:   genNOR3CNF(gate);   break;
+    	case Gate::XOR2:   genXOR2CNF(gate);   break;
+    	case Gate::XNOR2:  genXNOR2CNF(gate);  break;
+    	case Gate::MX2:    genMX2CNF(gate);    break;
+    	case Gate::OAI21:  genOAI21CNF(gate);  break;
+    	case Gate::AOI21:  genAOI21CNF(gate);  break;
+    	case Gate::CONST0: genCONST0CNF(gate); break;
+    	case Gate::CONST1: genCONST1CNF(gate); break;
+    	case Gate::CELL:   genCELLCNF(gate);   break;
+    	case Gate::DFF:                        break;
+    	case Gate::INPUT:                      break;
+    	case Gate::OUTPUT:                     break;
     	default: cerr << "Gate type is not in the CNF library" << endl; 
-    		       cerr << "Spec is: ";  gate_p->printType(); cerr << endl;
+    		       cerr << "Spec is: ";  Gate::printType(getGateType(gate)); cerr << endl;
     		       exit(1);
     }
+    d_cnfBegin.push_back(d_cnf.size());
   }
 }
 
-void Circuit::genBUFCNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(),  Y->getCnfVar());
-}
-
-void Circuit::genINVCNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause(-A->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(),  Y->getCnfVar());
-}
-
-void Circuit::genAND2CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(), Y->getCnfVar());
-}
-
-void Circuit::genAND3CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* C = gate_p->getInWire(2);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( C->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(), -C->getCnfVar(),
-                        Y->getCnfVar());
-}
-
-void Circuit::genOR2CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause(-A->getCnfVar(), Y->getCnfVar());
-  gate_p->addCNFClause(-B->getCnfVar(), Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(), B->getCnfVar(), -Y->getCnfVar());
-}
-
-void Circuit::genOR3CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* C = gate_p->getInWire(2);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause(-A->getCnfVar(), Y->getCnfVar());
-  gate_p->addCNFClause(-B->getCnfVar(), Y->getCnfVar());
-  gate_p->addCNFClause(-C->getCnfVar(), Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(), B->getCnfVar(), C->getCnfVar(),
-                       -Y->getCnfVar());
-}
-
-void Circuit::genNAND2CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( B->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(), -Y->getCnfVar());
-}
-
-void Circuit::genNAND3CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* C = gate_p->getInWire(2);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( B->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( C->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(), -C->getCnfVar(), 
-                       -Y->getCnfVar());
-}
-
-void Circuit::genNAND4CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* C = gate_p->getInWire(2);
-  Wire* D = gate_p->getInWire(3);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( B->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( C->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( D->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(), -C->getCnfVar(), 
-                       -D->getCnfVar(), -Y->getCnfVar());
-}
-
-void Circuit::genNOR2CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause(-A->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(),  B->getCnfVar(), Y->getCnfVar());
-}
-
-void Circuit::genNOR3CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* C = gate_p->getInWire(2);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause(-A->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-C->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(),  B->getCnfVar(), C->getCnfVar(), 
-                        Y->getCnfVar());
-}
-
-void Circuit::genXOR2CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(),  B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(), -B->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(),  B->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(), -Y->getCnfVar()); 
-}
-
-void Circuit::genXNOR2CNF(Gate* gate_p){
-  Wire* A = gate_p->getInWire(0);
-  Wire* B = gate_p->getInWire(1);
-  Wire* Y = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(),  B->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause( A->getCnfVar(), -B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(),  B->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(), -B->getCnfVar(),  Y->getCnfVar());
-}
-
-void Circuit::genMX2CNF(Gate* gate_p){
-  Wire* A  = gate_p->getInWire(0);
-  Wire* B  = gate_p->getInWire(1);
-  Wire* S0 = gate_p->getInWire(2);
-  Wire* Y  = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A->getCnfVar(),  S0->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause( B->getCnfVar(), -S0->getCnfVar(), -Y->getCnfVar());
-  gate_p->addCNFClause(-B->getCnfVar(), -S0->getCnfVar(),  Y->getCnfVar());
-  gate_p->addCNFClause(-A->getCnfVar(),  S0->getCnfVar(),  Y->getCnfVar());
-}
-
-void Circuit::genOAI21CNF(Gate* gate_p){
-  Wire* A0 = gate_p->getInWire(0);
-  Wire* A1 = gate_p->getInWire(1);
-  Wire* B0 = gate_p->getInWire(2);
-  Wire* Y  = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A0->getCnfVar(),  A1->getCnfVar(),   Y->getCnfVar());
-  gate_p->addCNFClause(-A1->getCnfVar(), -B0->getCnfVar(),  -Y->getCnfVar());
-  gate_p->addCNFClause(-A0->getCnfVar(), -B0->getCnfVar(),  -Y->getCnfVar());
-  gate_p->addCNFClause( B0->getCnfVar(),   Y->getCnfVar());
-}
-
-void Circuit::genAOI21CNF(Gate* gate_p){
-  Wire* A0 = gate_p->getInWire(0);
-  Wire* A1 = gate_p->getInWire(1);
-  Wire* B0 = gate_p->getInWire(2);
-  Wire* Y  = gate_p->getOutWire(0);
-  gate_p->addCNFClause( A0->getCnfVar(),  B0->getCnfVar(),   Y->getCnfVar());
-  gate_p->addCNFClause( A1->getCnfVar(),  B0->getCnfVar(),   Y->getCnfVar());
-  gate_p->addCNFClause(-A0->getCnfVar(), -B0->getCnfVar(),  -Y->getCnfVar());  
-  gate_p->addCNFClause(-B0->getCnfVar(),  -Y->getCnfVar());
-}
-
-void Circuit::genCONST0CNF(Gate* gate_p){
-	Wire* Y  = gate_p->getOutWire(0);
-	gate_p->addCNFClause(-Y->getCnfVar());
+void Circuit::addCNFClause(int v){
+  d_cnf.push_back(v);
+  d_cnf.push_back(0);
+}
+
+void Circuit::addCNFClause(int v1, int v2){
+  d_cnf.push_back(v1);
+  d_cnf.push_back(v2);
+  d_cnf.push_back(0);
+}
+
+void Circuit::addCNFClause(int v1, int v2, int v3){
+  d_cnf.push_back(v1);
+  d_cnf.push_back(v2);
+  d_cnf.push_back(v3);
+  d_cnf.push_back(0);
+}
+
+void Circuit::addCNFClause(int v1, int v2, int v3, int v4){
+  d_cnf.push_back(v1);
+  d_cnf.push_back(v2);
+  d_cnf.push_back(v3);
+  d_cnf.push_back(v4);
+  d_cnf.push_back(0);
+}
+
+void Circuit::addCNFClause(int v1, int v2, int v3, int v4, int v5){
+  d_cnf.push_back(v1);
+  d_cnf.push_back(v2);
+  d_cnf.push_back(v3);
+  d_cnf.push_back(v4);
+  d_cnf.push_back(v5);
+  d_cnf.push_back(0);
+}
+
+void Circuit::genBUFCNF(int gate){
+  int A = inVar(gate, 0);
+  int Y = outVar(gate, 0);
+  addCNFClause( A, -Y);
+  addCNFClause(-A,  Y);
+}
+
+void Circuit::genINVCNF(int gate){
+  int A = inVar(gate, 0);
+  int Y = outVar(gate, 0);
+  addCNFClause(-A, -Y);
+  addCNFClause( A,  Y);
+}
+
+void Circuit::genAND2CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int Y = outVar(gate, 0);
+  addCNFClause( A, -Y);
+  addCNFClause( B, -Y);
+  addCNFClause(-A, -B, Y);
+}
+
+void Circuit::genAND3CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int C = inVar(gate, 2);
+  int Y = outVar(gate, 0);
+  addCNFClause( A, -Y);
+  addCNFClause( B, -Y);
+  addCNFClause( C, -Y);
+  addCNFClause(-A, -B, -C,
+                        Y);
+}
+
+void Circuit::genOR2CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int Y = outVar(gate, 0);
+  addCNFClause(-A, Y);
+  addCNFClause(-B, Y);
+  addCNFClause( A, B, -Y);
+}
+
+void Circuit::genOR3CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int C = inVar(gate, 2);
+  int Y = outVar(gate, 0);
+  addCNFClause(-A, Y);
+  addCNFClause(-B, Y);
+  addCNFClause(-C, Y);
+  addCNFClause( A, B, C,
+                       -Y);
+}
+
+void Circuit::genNAND2CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int Y = outVar(gate, 0);
+  addCNFClause( A,  Y);
+  addCNFClause( B,  Y);
+  addCNFClause(-A, -B, -Y);
+}
+
+void Circuit::genNAND3CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int C = inVar(gate, 2);
+  int Y = outVar(gate, 0);
+  addCNFClause( A,  Y);
+  addCNFClause( B,  Y);
+  addCNFClause( C,  Y);
+  addCNFClause(-A, -B, -C, 
+                       -Y);
+}
+
+void Circuit::genNAND4CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int C = inVar(gate, 2);
+  int D = inVar(gate, 3);
+  int Y = outVar(gate, 0);
+  addCNFClause( A,  Y);
+  addCNFClause( B,  Y);
+  addCNFClause( C,  Y);
+  addCNFClause( D,  Y);
+  addCNFClause(-A, -B, -C, 
+                       -D, -Y);
+}
+
+void Circuit::genNOR2CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int Y = outVar(gate, 0);
+  addCNFClause(-A, -Y);
+  addCNFClause(-B, -Y);
+  addCNFClause( A,  B, Y);
+}
+
+void Circuit::genNOR3CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int C = inVar(gate, 2);
+  int Y = outVar(gate, 0);
+  addCNFClause(-A, -Y);
+  addCNFClause(-B, -Y);
+  addCNFClause(-C, -Y);
+  addCNFClause( A,  B, C, 
+                        Y);
+}
+
+void Circuit::genXOR2CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int Y = outVar(gate, 0);
+  addCNFClause( A,  B, -Y);
+  addCNFClause( A, -B,  Y);
+  addCNFClause(-A,  B,  Y);
+  addCNFClause(-A, -B, -Y); 
+}
+
+void Circuit::genXNOR2CNF(int gate){
+  int A = inVar(gate, 0);
+  int B = inVar(gate, 1);
+  int Y = outVar(gate, 0);
+  addCNFClause( A,  B,  Y);
+  addCNFClause( A, -B, -Y);
+  addCNFClause(-A,  B, -Y);
+  addCNFClause(-A, -B,  Y);
+}
+
+void Circuit::genMX2CNF(int gate){
+  int A  = inVar(gate, 0);
+  int B  = inVar(gate, 1);
+  int S0 = inVar(gate, 2);
+  int Y  = outVar(gate, 0);
+  addCNFClause( A,  S0, -Y);
+  addCNFClause( B, -S0, -Y);
+  addCNFClause(-B, -S0,  Y);
+  addCNFClause(-A,  S0,  Y);
+}
+
+void Circuit::genOAI21CNF(int gate){
+  int A0 = inVar(gate, 0);
+  int A1 = inVar(gate, 1);
+  int B0 = inVar(gate, 2);
+  int Y  = outVar(gate, 0);
+  addCNFClause( A0,  A1,   Y);
+  addCNFClause(-A1, -B0,  -Y);
+  addCNFClause(-A0, -B0,  -Y);
+  addCNFClause( B0,   Y);
+}
+
+void Circuit::genAOI21CNF(int gate){
+  int A0 = inVar(gate, 0);
+  int A1 = inVar(gate, 1);
+  int B0 = inVar(gate, 2);
+  int Y  = outVar(gate, 0);
+  addCNFClause( A0,  B0,   Y);
+  addCNFClause( A1,  B0,   Y);
+  addCNFClause(-A0, -A1,  -Y);  
+  addCNFClause(-B0,  -Y);
+}
+
+void Circuit::genCONST0CNF(int gate){
+	int Y  = outVar(gate, 0);
+	addCNFClause(-Y);
 	//cout << "Constant 0 wire: " << Y->getName() << endl;
 }
 
-void Circuit::genCONST1CNF(Gate* gate_p){
-	Wire* Y  = gate_p->getOutWire(0);
-	gate_p->addCNFClause( Y->getCnfVar());
+void Circuit::genCONST1CNF(int gate){
+	int Y  = outVar(gate, 0);
+	addCNFClause( Y);
+}
+
+// Clauses of an unconnected output are dropped, the output is free
+void Circuit::genCELLCNF(int gate){
+  int        cell = getCell(gate);
+  int        n    = d_library_p->numInputs(cell);
+  const int* lit  = d_library_p->getCNFClause(cell);
+  const int* end  = lit + d_library_p->cnfSize(cell);
+  int        pinVar[CellLibrary::MAX_INPUTS + CellLibrary::MAX_OUTPUTS] = {0};
+  
+  for(int i = 0; i < n; ++i)
+    pinVar[i] = inVar(gate, i);
+  for(int j = 0; j < outputSize(gate); ++j)
+    pinVar[n + getPort(gate, j) - '0'] = outVar(gate, j);
+  while(lit != end){
+    const int* clause = lit;
+    bool       connected = true;
+    for(; *lit != 0; ++lit)
+      connected = connected && pinVar[abs(*lit) - 1] != 0;
+    ++lit;
+    if(!connected)
+      continue;
+    for(; *clause != 0; ++clause)
+      d_cnf.push_back((*clause > 0) ? pinVar[*clause - 1] : -pinVar[-*clause - 1]);
+    d_cnf.push_back(0);
+  }
 }
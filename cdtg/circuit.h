@@ -3,90 +3,158 @@
 
 #include <string>
 #include <vector>
-#include <map>
+#include <stdio.h>
 #include "gate.h"
 #include "wire.h"
+#include "cellLibrary.h"
 
 using   namespace   std;
 
+// Flat netlist. Wires and gates are identified by their indices
+// 0 ... wireListSize()-1 and 0 ... gateListSize()-1, all attributes live in
+// parallel arrays and the pins of gates are stored in CSR form.
+// Gates are built one at a time: addGate() followed by the pins of that gate.
 class Circuit{
     private:
         // DATA
         string              d_name;
-        vector<Gate*>       d_gateList;
-        vector<Gate*>       d_dffList;
-        vector<Wire*>       d_wireList;
-        vector<Wire*>       d_piList;
-        vector<Wire*>       d_poList;
-        vector<Wire*>       d_ppiList;
-        vector<Wire*>       d_ppoList;
-        vector<Wire*>       d_clkList;
-        vector<Wire*>       d_rstList;
-        map<string, Wire*>  d_str2PI;
-        map<string, Wire*>  d_str2PPO;
+        
+        // Wires
+        vector<char>        d_namePool;     // Interned names, NUL terminated
+        vector<int>         d_nameBegin;    // Name of wire w starts at d_namePool[d_nameBegin[w]]
+        vector<unsigned>    d_nameHash;
+        vector<int>         d_symbolTable;  // Open addressing hash table of wire names, -1 if empty
+        vector<char>        d_wireType;     // Wire::wireType
+        vector<int>         d_wireCnfVar;
+        vector<int>         d_wireSource;   // Gate driving the wire, -1 if none
+        vector<int>         d_fanoutBegin;  // Gates reading wire w are d_fanout[d_fanoutBegin[w]] ... d_fanout[d_fanoutBegin[w+1]-1]
+        vector<int>         d_fanout;
+        
+        // Gates
+        vector<char>        d_gateType;     // Gate::gateType
+        vector<int>         d_inBegin;      // Input wires of gate g are d_in[d_inBegin[g]] ... d_in[d_inBegin[g+1]-1]
+        vector<int>         d_in;
+        vector<int>         d_outBegin;     // Output wires of gate g are d_out[d_outBegin[g]] ... d_out[d_outBegin[g+1]-1]
+        vector<int>         d_out;
+        vector<char>        d_outPort;      // d_outPort[k] gives the port of output pin d_out[k]: Q, N (QN), Y or '0' + output of a cell
+        vector<int>         d_gateCell;     // CellLibrary cell of CELL gates, -1 for other gates
+        vector<int>         d_cnfBegin;     // CNF of gate g is d_cnf[d_cnfBegin[g]] ... d_cnf[d_cnfBegin[g+1]-1], clauses end with 0
+        vector<int>         d_cnf;
+        
+        const CellLibrary*  d_library_p;    // Not owned
+        
+        // Indices of special gates and wires
+        vector<int>         d_dffList;
+        vector<int>         d_piList;
+        vector<int>         d_poList;
+        vector<int>         d_ppiList;
+        vector<int>         d_ppoList;
+        vector<int>         d_clkList;
+        vector<int>         d_rstList;
         
     public:
         // CREATORS
         Circuit();
-        ~Circuit();
         
         // MANIPULATORS
-        void    addGate         (Gate*);
-        void    addWire         (Wire*);
-        void    classifyWire    ();
+        int     addWire         (const string& name, Wire::wireType, int cnfVar);   // Returns the wire index
+        int     addWire         (const char* name, int length, Wire::wireType, int cnfVar);
+        void    setWireType     (int wire, Wire::wireType);
+        void    setLibrary      (const CellLibrary*);                               // Cells of CELL gates, set before adding gates
+        int     addGate         (Gate::gateType, int cell = -1);                    // Returns the gate index
+        void    addInWire       (int wire);                                         // Add an input pin to the last gate, cells in library pin order
+        void    addOutWire      (int wire, char port = 'Y');                        // Add an output pin to the last gate
+        void    classifyWire    ();                                                 // Build special lists and fanout arrays
         void    setName         (string);
         void    setCNF          ();
+        bool    readImage       (const char* begin, const char* end, int numVars); // Load writeImage() output, false if malformed
                 
         // ACCESSORS
         string getName();
+        const CellLibrary* getLibrary () const;   // NULL if none
         
-        // Get gates and wires by   indexing
-        Gate*   getGate(int);
-        Gate*   getDFF(int);
-        Wire*   getWire(int);
-        Wire*   getPI(int);
-        Wire*   getPI(string);
-        Wire*   getPO(int);
-        Wire*   getPPI(int);
-        Wire*   getPPO(int);
-        Wire*   getPPO(string);
-        Wire*   getCLK(int);
-        Wire*   getRST(int);
+        // Wires
+        int             findWire      (const char* name, int length) const;   // -1 if no such wire
+        int             findWire      (const string& name) const;
+        const char*     getWireName   (int wire) const;
+        Wire::wireType  getWireType   (int wire) const;
+        int             getCnfVar     (int wire) const;
+        int             getSourceGate (int wire) const;   // -1 if the wire is not driven by a gate
+        int             fanoutSize    (int wire) const;
+        int             getDestGate   (int wire, int i) const;
         
-        int     gateListSize();
-        int     dffListSize();
-        int     wireListSize();
-        int     PIListSize();
-        int     POListSize();
-        int     PPIListSize();
-        int     PPOListSize();
-        int     CLKListSize();
-        int     RSTListSize();
+        // Gates
+        Gate::gateType  getGateType   (int gate) const;
+        int             inputSize     (int gate) const;
+        int             outputSize    (int gate) const;
+        int             getInWire     (int gate, int i) const;
+        int             getOutWire    (int gate, int i) const;
+        char            getPort       (int gate, int i) const;   // Port of output i: Q, N (QN), Y or '0' + k for cell output k
+        int             getCell       (int gate) const;          // CellLibrary cell of a CELL gate, -1 otherwise
+        int             cnfSize       (int gate) const;          // Number of literals and clause ending 0s
+        const int*      getCNFClause  (int gate) const;
+        
+        // Get special gates and wires by indexing
+        int     getDFF(int) const;
+        int     getPI(int) const;
+        int     getPI(string) const;     // -1 if no such PI
+        int     getPO(int) const;
+        int     getPPI(int) const;
+        int     getPPO(int) const;
+        int     getPPO(string) const;    // -1 if no such PPO
+        int     getCLK(int) const;
+        int     getRST(int) const;
+        
+        int     gateListSize() const;
+        int     dffListSize() const;
+        int     wireListSize() const;
+        int     PIListSize() const;
+        int     POListSize() const;
+        int     PPIListSize() const;
+        int     PPOListSize() const;
+        int     CLKListSize() const;
+        int     RSTListSize() const;
         
         // Print functions
         void    printWireInfo();
         void    printGateInfo();
         
+        // Binary image of all arrays, readImage() copies them out of the mapped file
+        void    writeImage(FILE*) const;
+        
     private:
+        // Symbol table
+        static unsigned hashName (const char* name, int length);
+        void    insertSymbol(int wire);
+        void    placeSymbol (int wire);
+        
         // For CNF initialization
-        void    genBUFCNF   (Gate*);
-        void    genINVCNF   (Gate*);
-        void    genAND2CNF  (Gate*);
-        void    genAND3CNF  (Gate*);
-        void    genOR2CNF   (Gate*);
-        void    genOR3CNF   (Gate*);
-        void    genNAND2CNF (Gate*);
-        void    genNAND3CNF (Gate*);
-        void    genNAND4CNF (Gate*);
-        void    genNOR2CNF  (Gate*);
-        void    genNOR3CNF  (Gate*);
-        void    genXOR2CNF  (Gate*);
-        void    genXNOR2CNF (Gate*);
-        void    genMX2CNF   (Gate*);  // (S0 B) | ((!S0) A)
-        void    genOAI21CNF (Gate*);  // !((A0 | A1) B0)
-        void    genAOI21CNF (Gate*);  // !((A0 A1) | B0)
-        void    genCONST0CNF(Gate*);
-        void    genCONST1CNF(Gate*);
+        int     inVar       (int gate, int i) const { return d_wireCnfVar[d_in[d_inBegin[gate] + i]]; }
+        int     outVar      (int gate, int i) const { return d_wireCnfVar[d_out[d_outBegin[gate] + i]]; }
+        void    addCNFClause(int);
+        void    addCNFClause(int, int);
+        void    addCNFClause(int, int, int);
+        void    addCNFClause(int, int, int, int);
+        void    addCNFClause(int, int, int, int, int);
+        void    genBUFCNF   (int);
+        void    genINVCNF   (int);
+        void    genAND2CNF  (int);
+        void    genAND3CNF  (int);
+        void    genOR2CNF   (int);
+        void    genOR3CNF   (int);
+        void    genNAND2CNF (int);
+        void    genNAND3CNF (int);
+        void    genNAND4CNF (int);
+        void    genNOR2CNF  (int);
+        void    genNOR3CNF  (int);
+        void    genXOR2CNF  (int);
+        void    genXNOR2CNF (int);
+        void    genMX2CNF   (int);  // (S0 B) | ((!S0) A)
+        void    genOAI21CNF (int);  // !((A0 | A1) B0)
+        void    genAOI21CNF (int);  // !((A0 A1) | B0)
+        void    genCONST0CNF(int);
+        void    genCONST1CNF(int);
+        void    genCELLCNF  (int);  // Library clause template with the pins substituted
 };
 
 
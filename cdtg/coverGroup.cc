@@ -1,17 +1,15 @@
 #include "coverGroup.h"
+#include "image.h"
 #include <iostream>
 #include <assert.h>
+#include <limits.h>
+#include <map>
 
 // CREATORS
 CoverGroup::CoverGroup(){}
 
 CoverGroup::~CoverGroup(){
-    for(unsigned i=0;i<d_variableList.size();++i)
-        delete d_variableList.at(i);
-    for(unsigned i=0;i<d_coverPointList.size();++i)
-        delete d_coverPointList.at(i);
-    for(unsigned i=0;i<d_crossList.size();++i)
-        delete d_crossList.at(i);
+    clear();
 }
 
 // MANIPULATORS
@@ -35,6 +33,163 @@ void CoverGroup::addCross(Cross* cross_p){
     d_crossList.push_back(cross_p);
 }
 
+// The cross list of a cross may hold coverpoints it created for its variables,
+// they are not in the coverpoint list of the group
+void CoverGroup::resetEncoders(){
+    for(int i = 0; i < d_coverPointList.size(); ++i)
+        d_coverPointList.at(i)->resetDecoder();
+    for(int i = 0; i < d_crossList.size(); ++i){
+        const vector<CoverPoint*>& crossList = d_crossList.at(i)->getCrossList();
+        for(int j = 0; j < crossList.size(); ++j)
+            crossList.at(j)->resetDecoder();
+    }
+    d_termTable.reset();
+}
+
+void CoverGroup::resetBinCnf(){
+    vector<CoverPoint*> pointList = d_coverPointList;
+    
+    for(int i = 0; i < d_crossList.size(); ++i){
+        vector<CoverPoint*> crossList = d_crossList.at(i)->getCrossList();
+        pointList.insert(pointList.end(), crossList.begin(), crossList.end());
+        for(int j = 0; j < d_crossList.at(i)->numOfBin(); ++j)
+            d_crossList.at(i)->getBin(j)->setCnfVar(-1);
+    }
+    for(int i = 0; i < pointList.size(); ++i)
+        for(int j = 0; j < pointList.at(i)->numOfBin(); ++j)
+            pointList.at(i)->getBin(j)->setCnfVar(-1);
+    resetEncoders();
+}
+
+TermTable* CoverGroup::getTermTable(){
+    return &d_termTable;
+}
+
+bool CoverGroup::readImage(const char** pos_p, const char* end, int circuitVars, int numVars){
+    ImageRecord         record;
+    vector<CoverPoint*> pointList;   // Coverpoints of the group, then the ones created by crosses
+    vector<BaseBin*>    binList;     // State bins of pointList
+    string              name, spec;
+    int                 count, numGroupPoints = 0, numPoints, value, localBits = 0;
+    bool                ok;
+    
+    ok = record.read(pos_p, end) && record.get(&d_name) && record.get(&count, 0, INT_MAX);
+    // Variables: bits of PI and PPI variables are circuit variables, LOCAL ones follow them
+    // and are all the variables the covergroup allocates
+    for(int i = 0; ok && i < count; ++i){
+        int         type = CoverVariable::PI, bitwidth = 0;
+        vector<int> bits;
+        ok = record.get(&name) && record.get(&type, CoverVariable::PI, CoverVariable::LOCAL + 1) &&
+             record.get(&bitwidth, 1, INT_MAX);
+        if(!ok)
+            break;
+        const int lower = (type == CoverVariable::LOCAL) ? circuitVars + 1 : 1;
+        const int upper = (type == CoverVariable::LOCAL) ? numVars + 1 : circuitVars + 1;
+        for(int j = 0; ok && j < bitwidth; ++j){
+            ok = record.get(&value, lower, upper);
+            bits.push_back(value);
+        }
+        if(!ok)
+            break;
+        if(type == CoverVariable::LOCAL)
+            localBits += bitwidth;
+        CoverVariable* var_p = new CoverVariable(name, (CoverVariable::varType)type, bitwidth);
+        for(int j = 0; j < bitwidth; ++j)
+            var_p->setCnfVar(j, bits.at(j));
+        var_p->checkConsistence();
+        addVariable(var_p);
+    }
+    
+    ok = ok && numVars - circuitVars == localBits;
+    
+    // Coverpoints and their state bins
+    ok = ok && record.get(&numGroupPoints, 0, INT_MAX) && record.get(&numPoints, numGroupPoints, INT_MAX);
+    for(int i = 0; ok && i < numPoints; ++i){
+        int varIdx, msb, lsb, autoBinMax, numBins;
+        ok = record.get(&name) && record.get(&varIdx, 0, numOfVariable()) &&
+             record.get(&msb, 0, getVariable(varIdx)->getBitwidth()) && record.get(&lsb, 0, msb + 1) &&
+             record.get(&autoBinMax, 1, INT_MAX) && record.get(&numBins, 0, INT_MAX);
+        if(!ok)
+            break;
+        CoverVariable* var_p   = getVariable(varIdx);
+        CoverPoint*    point_p = new CoverPoint(name, msb, lsb, autoBinMax, var_p);
+        if(i < numGroupPoints)
+            addCoverPoint(point_p);
+        pointList.push_back(point_p);
+        for(int j = 0; ok && j < numBins; ++j){
+            int isExcluded, type, binMsb, binLsb, numIntervals, l, h;
+            ok = record.get(&name) && record.get(&isExcluded, 0, 2) && record.get(&type, BaseBin::SINGLE, BaseBin::FIXED_MULTI + 1) &&
+                 record.get(&binMsb, 0, var_p->getBitwidth()) && record.get(&binLsb, 0, binMsb + 1) &&
+                 record.get(&numIntervals, 0, INT_MAX);
+            if(!ok)
+                break;
+            StateBin* bin_p = new StateBin(name, isExcluded, (BaseBin::binType)type, binMsb, binLsb, point_p->getMaxVarValue(), var_p);
+            point_p->addBin(bin_p);
+            binList.push_back(bin_p);
+            for(int k = 0; ok && k < numIntervals; ++k){
+                ok = record.get(&l, INT_MIN, INT_MAX) && record.get(&h, l, INT_MAX);
+                if(ok)
+                    bin_p->addInterval(l, h);
+            }
+        }
+    }
+    
+    // Crosses, members of a cross bin are numbers in binList
+    ok = ok && record.get(&count, 0, INT_MAX);
+    for(int i = 0; ok && i < count; ++i){
+        int crossSize, numBins;
+        ok = record.get(&name) && record.get(&crossSize, 1, INT_MAX);
+        if(!ok)
+            break;
+        Cross* cross_p = new Cross(name, this);
+        addCross(cross_p);
+        for(int j = 0; ok && j < crossSize; ++j){
+            ok = record.get(&value, 0, pointList.size());
+            if(ok)
+                cross_p->addCoverPoint(pointList.at(value));
+        }
+        ok = ok && record.get(&numBins, 0, INT_MAX);
+        for(int j = 0; ok && j < numBins; ++j){
+            int                           isExcluded, numMembers, numSegments, size;
+            vector<BaseBin*>              memberList;
+            vector<vector<vector<int> > > segmentList;
+            ok = record.get(&name) && record.get(&isExcluded, 0, 2) && record.get(&spec) &&
+                 record.get(&numMembers, 0, INT_MAX);
+            for(int k = 0; ok && k < numMembers; ++k){
+                ok = record.get(&value, 0, binList.size());
+                if(ok)
+                    memberList.push_back(binList.at(value));
+            }
+            // A segment selects a non-empty list of members for every coverpoint of the cross
+            ok = ok && record.get(&numSegments, 0, INT_MAX);
+            for(int k = 0; ok && k < numSegments; ++k){
+                segmentList.push_back(vector<vector<int> >(crossSize));
+                for(int m = 0; ok && m < crossSize; ++m){
+                    ok = record.get(&size, 1, INT_MAX);
+                    for(int n = 0; ok && n < size; ++n){
+                        ok = record.get(&value, 0, memberList.size());
+                        if(ok)
+                            segmentList.back().at(m).push_back(value);
+                    }
+                }
+            }
+            if(!ok)
+                break;
+            CrossBin* bin_p = new CrossBin(name, isExcluded, cross_p->getCrossList());
+            bin_p->setSelection(spec, memberList, segmentList);
+            cross_p->addBin(bin_p);
+        }
+    }
+    
+    ok = ok && record.done();
+    if(!ok){
+        for(int i = numGroupPoints; i < pointList.size(); ++i)
+            delete pointList.at(i);
+        clear();
+    }
+    return ok;
+}
+
 // ACCESSORS
 string CoverGroup::getName() const{
     return d_name;
@@ -131,6 +286,103 @@ int CoverGroup::numOfBin() const{
     return num;
 }
 
+void CoverGroup::getBinList(vector<BaseBin*>* binList_p) const{
+    binList_p->clear();
+    for(int i = 0; i < d_coverPointList.size(); ++i)
+        for(int j = 0; j < d_coverPointList.at(i)->numOfBin(); ++j)
+            binList_p->push_back(d_coverPointList.at(i)->getBin(j));
+    for(int i = 0; i < d_crossList.size(); ++i)
+        for(int j = 0; j < d_crossList.at(i)->numOfBin(); ++j)
+            binList_p->push_back(d_crossList.at(i)->getBin(j));
+}
+
+// The parsed covergroup, coverpoints created by crosses for their variables follow
+// the coverpoints of the group and state bins are numbered over all of them
+void CoverGroup::writeImage(FILE* file) const{
+    ImageRecord                record;
+    vector<CoverPoint*>        pointList = d_coverPointList;
+    map<CoverVariable*, int>   varIdx;
+    map<CoverPoint*, int>      pointIdx;
+    map<BaseBin*, int>         binIdx;
+    
+    record.put(d_name);
+    record.put(d_variableList.size());
+    for(int i = 0; i < d_variableList.size(); ++i){
+        CoverVariable* var_p = d_variableList.at(i);
+        varIdx[var_p] = i;
+        record.put(var_p->getName());
+        record.put(var_p->getType());
+        record.put(var_p->getBitwidth());
+        for(int j = 0; j < var_p->getBitwidth(); ++j)
+            record.put(var_p->getCnfVar(j));
+    }
+    
+    for(int i = 0; i < pointList.size(); ++i)
+        pointIdx[pointList.at(i)] = i;
+    for(int i = 0; i < d_crossList.size(); ++i){
+        vector<CoverPoint*> crossList = d_crossList.at(i)->getCrossList();
+        for(int j = 0; j < crossList.size(); ++j)
+            if(pointIdx.find(crossList.at(j)) == pointIdx.end()){
+                pointIdx[crossList.at(j)] = pointList.size();
+                pointList.push_back(crossList.at(j));
+            }
+    }
+    record.put(d_coverPointList.size());
+    record.put(pointList.size());
+    for(int i = 0; i < pointList.size(); ++i){
+        CoverPoint* point_p = pointList.at(i);
+        record.put(point_p->getName());
+        record.put(varIdx[point_p->getVar()]);
+        record.put(point_p->getMSB());
+        record.put(point_p->getLSB());
+        record.put(point_p->getAutoBinMax());
+        record.put(point_p->numOfBin());
+        for(int j = 0; j < point_p->numOfBin(); ++j){
+            const StateBin* bin_p = static_cast<const StateBin*>(point_p->getBin(j)); // Coverpoints only hold state bins
+            const int       index = binIdx.size();
+            binIdx[point_p->getBin(j)] = index;
+            record.put(bin_p->getName());
+            record.put(bin_p->isExcluded());
+            record.put(bin_p->getType());
+            record.put(bin_p->getMSB());
+            record.put(bin_p->getLSB());
+            record.put(bin_p->getIntervals().iterative_size());
+            for(interval_set<int>::const_iterator it = bin_p->getIntervals().begin(); it != bin_p->getIntervals().end(); ++it){
+                record.put(first(*it));
+                record.put(last(*it));
+            }
+        }
+    }
+    
+    record.put(d_crossList.size());
+    for(int i = 0; i < d_crossList.size(); ++i){
+        vector<CoverPoint*> crossList = d_crossList.at(i)->getCrossList();
+        record.put(d_crossList.at(i)->getName());
+        record.put(crossList.size());
+        for(int j = 0; j < crossList.size(); ++j)
+            record.put(pointIdx[crossList.at(j)]);
+        record.put(d_crossList.at(i)->numOfBin());
+        for(int j = 0; j < d_crossList.at(i)->numOfBin(); ++j){
+            const CrossBin* bin_p = static_cast<const CrossBin*>(d_crossList.at(i)->getBin(j));
+            const vector<vector<vector<int> > >& segmentList = bin_p->getSegmentList();
+            record.put(bin_p->getName());
+            record.put(bin_p->isExcluded());
+            record.put(bin_p->getSelecSpec());
+            record.put(bin_p->getMemberList().size());
+            for(int k = 0; k < bin_p->getMemberList().size(); ++k)
+                record.put(binIdx[bin_p->getMemberList().at(k)]);
+            record.put(segmentList.size());
+            for(int k = 0; k < segmentList.size(); ++k)
+                for(int m = 0; m < segmentList.at(k).size(); ++m){
+                    record.put(segmentList.at(k).at(m).size());
+                    for(int n = 0; n < segmentList.at(k).at(m).size(); ++n)
+                        record.put(segmentList.at(k).at(m).at(n));
+                }
+        }
+    }
+    record.write(file);
+}
+
 // Debug function
 void CoverGroup::printVariableInfo(){
     cout << "==============================================================\n";
@@ -177,3 +429,16 @@ void CoverGroup::printCrossInfo(){
     }
 }
 
+void CoverGroup::clear(){
+    for(unsigned i=0;i<d_variableList.size();++i)
+        delete d_variableList.at(i);
+    for(unsigned i=0;i<d_coverPointList.size();++i)
+        delete d_coverPointList.at(i);
+    for(unsigned i=0;i<d_crossList.size();++i)
+        delete d_crossList.at(i);
+    d_variableList.clear();
+    d_coverPointList.clear();
+    d_crossList.clear();
+    d_termTable.reset();
+    d_name.clear();
+}
@@ -3,9 +3,11 @@
 
 #include <string>
 #include <vector>
+#include <stdio.h>
 #include "coverVariable.h"
 #include "coverPoint.h"
 #include "cross.h"
+#include "termTable.h"
 //#include "circuit.h"
 
 class Cross;
@@ -18,6 +20,7 @@ class CoverGroup{
     vector<CoverVariable*>  d_variableList;
     vector<CoverPoint*>     d_coverPointList;
     vector<Cross*>          d_crossList;
+    TermTable               d_termTable;    // AND/OR terms shared by the cross bins of one frame
       
     public:
         // CREATORS
@@ -31,6 +34,13 @@ class CoverGroup{
         void addVariable(CoverVariable*);
         void addCoverPoint(CoverPoint*);
         void addCross(Cross*);
+        void resetEncoders();               // Drop the decoders and the shared terms, the next bin CNF is for another frame or solver
+        void resetBinCnf();                 // Drop the CNF variables of all bins, the decoders and the shared terms
+        void clear();                       // Delete the variables, coverpoints and crosses
+        TermTable* getTermTable();
+        // Load writeImage() output, false if malformed. Bits of PI and PPI variables are
+        // circuit variables up to circuitVars, LOCAL ones follow up to numVars
+        bool readImage(const char** pos_p, const char* end, int circuitVars, int numVars);
         
         // ACCESSORS
         string          getName() const;
@@ -49,6 +59,8 @@ class CoverGroup{
         int             numOfCoverPoint() const;
         int             numOfCross() const;
         int             numOfBin() const;
+        void            getBinList(vector<BaseBin*>*) const;    // Bins of the coverpoints, then of the crosses
+        void            writeImage(FILE*) const;
         
         // Debug function
         void printVariableInfo();
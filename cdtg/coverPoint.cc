@@ -29,6 +29,8 @@ CoverPoint::~CoverPoint(){
 
 // MANIPULATORS
 void CoverPoint::addBin(BaseBin* bin_p){
+	if(typeid(*bin_p)==typeid(StateBin))
+	  static_cast<StateBin*>(bin_p)->setDecoder(&d_decoder);
 	d_binList.push_back(bin_p);
 }
 
@@ -36,6 +38,10 @@ void CoverPoint::setCnfVar(const int& cnfVar){
 	d_cnfVar = cnfVar;
 }
 
+void CoverPoint::resetDecoder(){
+	d_decoder.reset();
+}
+
 // ACCESSORS
 const string& CoverPoint::getName() const{
   return d_name;	
@@ -3,6 +3,7 @@
 
 #include "baseBin.h"
 #include "coverVariable.h"
+#include "valueDecoder.h"
 #include<string>
 #include<vector>
 
@@ -20,6 +21,7 @@ class CoverPoint{
 	    // for example: "coverpoint v_a + v_b" samples variables v_a and v_b
 	    // but we currently assume a single variable is sampled
 	  vector<BaseBin*> d_binList;
+	  ValueDecoder     d_decoder;      // Value trie shared by the CNF of all state bins
 	  
 	public:
 		// CREATORS
@@ -29,6 +31,7 @@ class CoverPoint{
 		// MANIPULATORS		
 		void           addBin(BaseBin*);
 		void           setCnfVar(const int&);
+		void           resetDecoder();     // Drop the decoder nodes, the next bin CNF goes to another solver
 		
 		// ACCESSORS
 		const string&  getName()          const;
@@ -51,6 +51,10 @@ int CoverVariable::getBitwidth() const{
 	return d_bitwidth;
 }
 
+CoverVariable::varType CoverVariable::getType() const{
+	return d_type;
+}
+
 long int CoverVariable::getValue(int t) const{
 	return d_valueList.at(t);
 }
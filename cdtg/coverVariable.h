@@ -33,6 +33,7 @@ class CoverVariable{
         // ACCESSORS
         string              getName          ()    const;
         int                 getBitwidth      ()    const;
+        varType             getType          ()    const;
         long int            getValue         (int) const;
         int                 getCnfVar        (int) const;
         
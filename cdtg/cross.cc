@@ -89,8 +89,14 @@ void Cross::setSpec(string* str_p){
  
 }
 
+void Cross::addCoverPoint(CoverPoint* point_p){
+    d_crossList.push_back(point_p);
+    d_crossSize = d_crossList.size();
+}
+
 void Cross::addBin(CrossBin* bin_p){
     d_binList.push_back(bin_p);
+    bin_p->setTermTable(d_belongGroup_p->getTermTable());
 }
 
 void Cross::setCnfVar(const int& cnfVar){
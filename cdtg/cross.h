@@ -31,6 +31,7 @@ class Cross{
         
         // MANIPULATORS     
         void    setSpec(string*);
+        void    addCoverPoint(CoverPoint*);   // Append to the cross list, setSpec() does it from the spec
         void    addBin(CrossBin*);
         void    setCnfVar(const int&);
         
@@ -3,6 +3,8 @@
 #include <assert.h>
 #include <limits.h>
 #include <typeinfo>
+#include <map>
+#include <algorithm>
 
 using namespace std;
 
@@ -13,6 +15,7 @@ CrossBin::CrossBin(const string& name, const bool& isExcluded, vector<CoverPoint
     d_isExcluded = isExcluded;
     d_crossList  = crossList;
     d_hitCount   = 0;
+    d_termTable_p = NULL;
 }
 
 CrossBin::~CrossBin(){}
@@ -93,8 +96,8 @@ void CrossBin::setSpec(string* binStr_p){
             }
         }
         
-        // Generate cross products
-        genCrossProducts(&binsToCross);
+        // Record the selection, its cross products are not expanded
+        addSegment(binsToCross);
         
         // Reset binsToCross
         for(int i = 0; i < d_crossList.size(); ++i)
@@ -108,40 +111,54 @@ void CrossBin::setCnfVar(const int cnfVar){
     d_cnfVar = cnfVar;
 }
 
+void CrossBin::setTermTable(TermTable* termTable_p){
+    d_termTable_p = termTable_p;
+}
+
+void CrossBin::setSelection(const string& selectSpec, const vector<BaseBin*>& memberList,
+                            const vector<vector<vector<int> > >& segmentList){
+    d_selectSpec  = selectSpec;
+    d_memberList  = memberList;
+    d_segmentList = segmentList;
+}
+
+// An explicit tuple, a segment of single bins
 void CrossBin::addCrossProduct(vector<BaseBin*> crossProduct){
-    d_crossProductList.push_back(crossProduct);
+    vector<vector<BaseBin*> > segment;
+    for(int i = 0; i < crossProduct.size(); ++i)
+        segment.push_back(vector<BaseBin*>(1, crossProduct.at(i)));
+    addSegment(segment);
 }
 
-void CrossBin::genCnf(int* cnfVar_p){
+// =============================================================================================
+// The bin is the OR of its segments and a segment is the AND over coverpoints
+// of the OR of the bins selected from that coverpoint, so a selection of
+// n1 x n2 x ... bins costs n1 + n2 + ... clauses instead of one AND per tuple.
+// ORs and ANDs come from the term table, so a term over the same bins is
+// defined once per frame and shared by all cross bins of the covergroup.
+// =============================================================================================
+void CrossBin::genCnf(int* cnfVar_p, bool positiveOnly){
     d_cnfClause.clear(); // Generate a new set of clauses
-    BaseBin* baseBin_p;
-    vector<int> binCnfVars_v, productCnfVars_v;
+    d_positiveOnly = positiveOnly;
+    TermTable localTable;
+    TermTable* table_p = (d_termTable_p != NULL) ? d_termTable_p : &localTable;
+    vector<int> factorCnfVars_v, segmentCnfVars_v;
     
-    for(int i = 0; i < d_crossProductList.size(); ++i){
-        for(int j = 0; j < d_crossProductList.at(i).size(); ++j){
-            baseBin_p = d_crossProductList[i][j];
-            if(baseBin_p->getCnfVar() != -1){
-              binCnfVars_v.push_back(baseBin_p->getCnfVar());
-            }
-            else{// The bin has not been initial
-                baseBin_p->setCnfVar(++(*cnfVar_p));
-                binCnfVars_v.push_back(*cnfVar_p);
-                baseBin_p->genCnf(cnfVar_p);
-                /////////////////// !!!!!!!!!!!  Important !!!!!!!!! //////////////////////////////////////
-                // Generated clauses need to be added to solver, now we put them to d_cnfClause ..
-                const vector<int> binClause = baseBin_p->getCNFClause();
-                for(int k = 0; k < binClause.size(); ++k)
-                  d_cnfClause.push_back(binClause.at(k));
-            }
+    for(int i = 0; i < d_segmentList.size(); ++i){
+        factorCnfVars_v.clear();
+        for(int j = 0; j < d_segmentList.at(i).size(); ++j){
+            const vector<int>& factor = d_segmentList[i][j];
+            vector<int> binCnfVars_v;
+            for(int k = 0; k < factor.size(); ++k)
+                binCnfVars_v.push_back(binCnfVar(d_memberList.at(factor.at(k)), cnfVar_p));
+            factorCnfVars_v.push_back(table_p->orLit(binCnfVars_v, cnfVar_p, positiveOnly, &d_cnfClause));
         }
-        // AND CNF variables
-        productCnfVars_v.push_back(++(*cnfVar_p)); // push CNF variable of product term
-        genAndCnf(binCnfVars_v, *cnfVar_p);
-        binCnfVars_v.clear();
+        // AND CNF variables of the coverpoints
+        segmentCnfVars_v.push_back(table_p->andLit(factorCnfVars_v, cnfVar_p, positiveOnly, &d_cnfClause));
     }
     
-    // OR cross product CNF variables
-    genOrCnf(productCnfVars_v, d_cnfVar);
+    // OR segment CNF variables
+    genOrCnf(segmentCnfVars_v, d_cnfVar);
 }
 
 void CrossBin::plusCount(){
@@ -165,17 +182,35 @@ const int& CrossBin::getHitCount() const{
     return d_hitCount;
 }
 
+const bool& CrossBin::isExcluded() const{
+    return d_isExcluded;
+}
+
+const vector<BaseBin*>& CrossBin::getMemberList() const{
+    return d_memberList;
+}
+
+const vector<vector<vector<int> > >& CrossBin::getSegmentList() const{
+    return d_segmentList;
+}
+
+// Tuples are enumerated one at a time
 void CrossBin::print() const{
     //cout << "=============================================" << endl;
     //cout << "Selection spec: " << d_selectSpec << endl;
-    for(int i = 0; i < d_crossProductList.size(); ++i){
-        cout << "     <";
-        for(int j = 0; j < d_crossProductList[i].size(); ++j){
-            cout << d_crossProductList[i][j]->getName();
-            if(j != d_crossProductList[i].size() - 1)               
-                cout << ", ";
-        }
-        cout << ">" << endl;
+    vector<int> pos;
+    for(int i = 0; i < d_segmentList.size(); ++i){
+        const vector<vector<int> >& segment = d_segmentList.at(i);
+        pos.assign(segment.size(), 0);
+        do{
+            cout << "     <";
+            for(int j = 0; j < segment.size(); ++j){
+                cout << d_memberList.at(segment[j][pos[j]])->getName();
+                if(j != segment.size() - 1)               
+                    cout << ", ";
+            }
+            cout << ">" << endl;
+        }while(nextProduct(segment, &pos));
     }   
 }
 
@@ -183,6 +218,40 @@ const vector<int>& CrossBin::getCNFClause() const{
     return d_cnfClause;
 }
 
+// Member bins shared by several segments are evaluated once, their lanes are
+// kept by position in d_memberList. A single segment uses every member once.
+SimWord CrossBin::simHit(const Simulator& sim, int word) const{
+    vector<SimWord> memberHit;
+    vector<char>    known;
+    SimWord         hit = 0;
+    
+    if(d_segmentList.size() > 1){
+        memberHit.resize(d_memberList.size());
+        known.assign(d_memberList.size(), 0);
+    }
+    for(int i = 0; i < d_segmentList.size(); ++i){
+        SimWord product = ~(SimWord)0;
+        for(int j = 0; j < d_segmentList.at(i).size() && product != 0; ++j){
+            SimWord factor = 0;
+            for(int k = 0; k < d_segmentList[i][j].size(); ++k){
+                int member = d_segmentList[i][j][k];
+                if(known.empty())
+                    factor |= d_memberList[member]->simHit(sim, word);
+                else{
+                    if(!known[member]){
+                        memberHit[member] = d_memberList[member]->simHit(sim, word);
+                        known[member]     = 1;
+                    }
+                    factor |= memberHit[member];
+                }
+            }
+            product &= factor;
+        }
+        hit |= product;
+    }
+    return hit;
+}
+
 void CrossBin::printClause() const{
     for(int i = 0; i < d_cnfClause.size(); ++i){
         if(d_cnfClause[i] == 0)
@@ -219,8 +288,8 @@ void CrossBin::selectBins(const bool& isNegative, string* binsSelect, vector<vec
 //cout << "==========================================\nStart to select: " << *binsSelect << endl;   
     // Get id of of current selection
     if(find2!=string::npos){
-        ointName = binsSelect->substr(find1+1, find2-find1-1);
-        inName = binsSelect->substr(find2+1, find3-find2-1);
+        pointName = binsSelect->substr(find1+1, find2-find1-1);
+        binName = binsSelect->substr(find2+1, find3-find2-1);
     }
     else{
         pointName = binsSelect->substr(find1+1, find3-find1-1);
@@ -346,53 +415,67 @@ void CrossBin::selectBins(const bool& isNegative, string* binsSelect, vector<vec
 }
 
 // =============================================================================================
-// Function genCrossProducts()
-// generates cross products of bins according to "binsToCross_p"
-// and put results to "d_crossProductList".
+// Function addSegment()
+// records one selection, "binsToCross" holds the selected bins of every
+// coverpoint in the order of the cross list. A coverpoint without selected
+// bins leaves the selection without cross products, it is dropped.
+// Bins are stored as positions in d_memberList, which lists a bin selected by
+// several segments once.
 // Note that duplicated cross products are not checked
 // due to potential complexity.
 // =============================================================================================
-void CrossBin::genCrossProducts(vector<vector<BaseBin*> >* binsToCross_p){
-    vector<int> loopTime;
-    int max = 1;
-    vector<BaseBin*> tempProduct;
-  
-    const int cross_size = binsToCross_p->size();
-    for(int i = 0; i < cross_size; ++i)
-        loopTime.push_back(binsToCross_p->at(i).size());
-      
-    for(int i = 0; i < loopTime.size(); ++i)
-        max *= loopTime.at(i);
+void CrossBin::addSegment(const vector<vector<BaseBin*> >& binsToCross){
+    map<const BaseBin*, int> position;
     
-    for(int i = 0; i < max; ++i){
-        int t = i;
-        tempProduct.clear();
-        for(int j = 0; j < loopTime.size(); ++j){
-            int idx = t%loopTime.at(j);
-            tempProduct.push_back(binsToCross_p->at(j).at(idx));      
-            t /= loopTime.at(j);
-        }
-        d_crossProductList.push_back(tempProduct);
+    for(int i = 0; i < binsToCross.size(); ++i){
+        if(binsToCross.at(i).empty())
+            return;
     }
+    for(int m = 0; m < d_memberList.size(); ++m)
+        position[d_memberList.at(m)] = m;
+    d_segmentList.push_back(vector<vector<int> >(binsToCross.size()));
+    for(int j = 0; j < binsToCross.size(); ++j)
+        for(int k = 0; k < binsToCross.at(j).size(); ++k){
+            BaseBin* baseBin_p = binsToCross[j][k];
+            map<const BaseBin*, int>::iterator it = position.find(baseBin_p);
+            if(it == position.end()){
+                it = position.insert(make_pair(baseBin_p, (int)d_memberList.size())).first;
+                d_memberList.push_back(baseBin_p);
+            }
+            d_segmentList.back().at(j).push_back(it->second);
+        }
 }
 
-// CLAUSE GENERATION FUNCTIONS
-
-void CrossBin::genAndCnf(const vector<int>& cnfVarVec, int cnfVar){
-    for(int i=0;i<cnfVarVec.size();++i){
-        d_cnfClause.push_back(cnfVarVec[i]);
-        d_cnfClause.push_back(-cnfVar);
-        d_cnfClause.push_back(0);
-    }
-    for(int i=0;i<cnfVarVec.size();++i){
-        d_cnfClause.push_back(-cnfVarVec[i]);
+// Advances pos to the next tuple of segment, the first coverpoint varies fastest.
+// False after the last tuple.
+bool CrossBin::nextProduct(const vector<vector<int> >& segment, vector<int>* pos){
+    for(int j = 0; j < segment.size(); ++j){
+        if(++pos->at(j) < segment.at(j).size())
+            return true;
+        pos->at(j) = 0;
     }
-    d_cnfClause.push_back(cnfVar);
-    d_cnfClause.push_back(0);
+    return false;
 }
 
+// CNF variable of a bin of the cross list, its clauses are generated on first use
+int CrossBin::binCnfVar(BaseBin* baseBin_p, int* cnfVar_p){
+    if(baseBin_p->getCnfVar() != -1)
+        return baseBin_p->getCnfVar();
+    // The bin has not been initial
+    baseBin_p->setCnfVar(++(*cnfVar_p));
+    baseBin_p->genCnf(cnfVar_p, d_positiveOnly);
+    /////////////////// !!!!!!!!!!!  Important !!!!!!!!! //////////////////////////////////////
+    // Generated clauses need to be added to solver, now we put them to d_cnfClause ..
+    const vector<int>& binClause = baseBin_p->getCNFClause();
+    for(int k = 0; k < binClause.size(); ++k)
+        d_cnfClause.push_back(binClause.at(k));
+    return baseBin_p->getCnfVar();
+}
+
+// CLAUSE GENERATION FUNCTIONS
+
 void CrossBin::genOrCnf(const vector<int>& cnfVarVec, int cnfVar){
-    for(int i=0;i<cnfVarVec.size();++i){
+    for(int i=0;!d_positiveOnly && i<cnfVarVec.size();++i){
         d_cnfClause.push_back(-cnfVarVec[i]);
         d_cnfClause.push_back(cnfVar);
         d_cnfClause.push_back(0);
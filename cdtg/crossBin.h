@@ -4,6 +4,7 @@
 #include "baseBin.h"
 #include "stateBin.h"
 #include "coverPoint.h"
+#include "termTable.h"
 #include <string>
 #include <vector>
 #include <boost/icl/interval_set.hpp>
@@ -22,10 +23,15 @@ class CrossBin : public BaseBin{
     // binType                d_type;
     // int                    d_hitCount;
     // vector<int>            d_cnfClause;
+    // bool                   d_positiveOnly;
     
     string                    d_selectSpec;
     vector<CoverPoint*>       d_crossList;          // Coverpoints in the cross list
-    vector<vector<BaseBin*> > d_crossProductList;
+    // Selections joined by "||", a segment holds the selected bins of every coverpoint
+    // and stands for the product of its lists, which is never materialized
+    vector<BaseBin*>          d_memberList;         // Distinct bins of the segments
+    vector<vector<vector<int> > > d_segmentList;    // Positions in d_memberList
+    TermTable*                d_termTable_p;        // Terms shared by the cross bins of the covergroup, NULL: bin-local
 
     public:
         // CREATORS
@@ -35,26 +41,35 @@ class CrossBin : public BaseBin{
         // MANIPULATORS
         void setSpec(string* specString);
         void setCnfVar(const int cnfVar);
+        void setTermTable(TermTable*);
+        // Restore a selection of setSpec(), memberList holds bins of the cross list
+        void setSelection(const string& selectSpec, const vector<BaseBin*>& memberList,
+                          const vector<vector<vector<int> > >& segmentList);
         void addCrossProduct(vector<BaseBin*> crossProduct);
-        void genCnf(int*);
+        void genCnf(int*, bool positiveOnly);
         void plusCount();
         
         // ACCESSORS
         const string&       getName      () const;
         const int&          getCnfVar    () const;
         const int&          getHitCount  () const;
+        const bool&         isExcluded   () const;
         void                print        () const;
         void                printClause  () const;
         const vector<int>&  getCNFClause () const;
+        SimWord             simHit       (const Simulator&, int word) const;
         const string&       getSelecSpec () const;
+        const vector<BaseBin*>&               getMemberList  () const;
+        const vector<vector<vector<int> > >&  getSegmentList () const;
         
     private:
         // UTILITIES
         void selectBins(const bool&, string*, vector<vector<BaseBin*> >*);
-        void genCrossProducts(vector<vector<BaseBin*> >*);
+        void addSegment(const vector<vector<BaseBin*> >&);
+        static bool nextProduct(const vector<vector<int> >&, vector<int>*);
+        int  binCnfVar(BaseBin*, int*);
         
         // CLAUSE GENERATION FUNCTIONS
-        void genAndCnf(const vector<int>&,int);
         void genOrCnf(const vector<int>&,int);
 };
 
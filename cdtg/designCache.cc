@@ -0,0 +1,259 @@
+#include "designCache.h"
+#include "global.h"
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Followed by Circuit::writeImage(), or by CoverGroup::writeImage() and BinTemplate::writeImage()
+struct ImageHeader{
+    char               magic[8];
+    unsigned long long version;
+    unsigned long long key;
+    unsigned long long size;       // Input file size, checked along with the key
+    long long          numVars;
+    unsigned long long checksum;   // hashBytes() of the payload
+};
+
+static const char IMAGE_MAGIC[8] = "CDTGIMG";
+static const char COVER_MAGIC[8] = "CDTGCOV";
+
+// CREATORS
+DesignCache::DesignCache(const char* dir){
+    d_dir       = (dir == NULL) ? "" : dir;
+    d_hasKey    = false;
+    d_key       = 0;
+    d_size      = 0;
+    d_coverKey  = 0;
+    d_coverSize = 0;
+}
+
+// MANIPULATORS
+bool DesignCache::load(const char* netlist, Circuit* circuit_p, int* numVars_p){
+    char        name[32];
+    ImageHeader header;
+    const char* image;
+    size_t      length;
+    bool        ok = false;
+
+    d_path.clear();
+    d_hasKey = !d_dir.empty() && hashFile(netlist, &d_key, &d_size);
+    if(!d_hasKey)
+        return false;
+    if(circuit_p->getLibrary() != NULL){   // Gates of library cells refer to cell indices
+        d_key ^= circuit_p->getLibrary()->signature();
+        d_key *= 0xC2B2AE3D27D4EB4FULL;
+    }
+    snprintf(name, sizeof(name), "%016llx.img", d_key);
+    d_path = d_dir + "/" + name;
+
+    if((image = mapImage(d_path, IMAGE_MAGIC, d_key, d_size, &header, &length)) != NULL){
+        ok = circuit_p->readImage(image + sizeof(header), image + length, header.numVars);
+        munmap((void*)image, length);
+    }
+    if(!ok)
+        return false;
+    *numVars_p = header.numVars;
+    d_path.clear();   // Nothing to save
+    cout << "Circuit image loaded from " << d_dir << "/" << name << endl;
+    return true;
+}
+
+void DesignCache::save(const Circuit& circuit, int numVars){
+    ImageHeader header;
+    FILE*       file;
+
+    if(d_path.empty())
+        return;
+    string temp = d_path + ".tmp" + Global::int2str(getpid());
+    if((file = openImage(temp, IMAGE_MAGIC, d_key, d_size, numVars, &header)) == NULL){
+        cout << "Cannot write circuit image " << temp << endl;
+        return;
+    }
+    circuit.writeImage(file);
+    if(closeImage(file, &header, temp, d_path))
+        cout << "Circuit image saved to " << d_path << endl;
+    else
+        cout << "Cannot write circuit image " << d_path << endl;
+}
+
+bool DesignCache::loadCover(const char* coverFile, bool positiveOnly, CoverGroup* coverGroup_p,
+                            BinTemplate* binTemplate_p, int* numVars_p){
+    char        name[32];
+    ImageHeader header;
+    const char* image;
+    size_t      length;
+    bool        ok = false;
+
+    d_coverPath.clear();
+    if(!d_hasKey || !hashFile(coverFile, &d_coverKey, &d_coverSize))
+        return false;
+    // Covergroup variables are variables of the circuit image, the bin CNF depends on positiveOnly
+    d_coverKey ^= d_key;
+    d_coverKey *= 0xC2B2AE3D27D4EB4FULL;
+    d_coverKey += positiveOnly;
+    snprintf(name, sizeof(name), "%016llx.cov", d_coverKey);
+    d_coverPath = d_dir + "/" + name;
+
+    if((image = mapImage(d_coverPath, COVER_MAGIC, d_coverKey, d_coverSize, &header, &length)) != NULL){
+        const char* pos = image + sizeof(header);
+        ok = header.numVars >= *numVars_p &&
+             coverGroup_p->readImage(&pos, image + length, *numVars_p, header.numVars);
+        ok = ok && binTemplate_p->readImage(&pos, image + length, *coverGroup_p) && pos == image + length;
+        munmap((void*)image, length);
+    }
+    if(!ok){
+        coverGroup_p->clear();
+        binTemplate_p->clear();
+        return false;
+    }
+    *numVars_p = header.numVars;
+    d_coverPath.clear();   // Nothing to save
+    cout << "Covergroup image loaded from " << d_dir << "/" << name << endl;
+    return true;
+}
+
+void DesignCache::saveCover(const CoverGroup& coverGroup, const BinTemplate& binTemplate, int numVars){
+    ImageHeader header;
+    FILE*       file;
+
+    if(d_coverPath.empty())
+        return;
+    string temp = d_coverPath + ".tmp" + Global::int2str(getpid());
+    if((file = openImage(temp, COVER_MAGIC, d_coverKey, d_coverSize, numVars, &header)) == NULL){
+        cout << "Cannot write covergroup image " << temp << endl;
+        return;
+    }
+    coverGroup.writeImage(file);
+    binTemplate.writeImage(file);
+    if(closeImage(file, &header, temp, d_coverPath))
+        cout << "Covergroup image saved to " << d_coverPath << endl;
+    else
+        cout << "Cannot write covergroup image " << d_coverPath << endl;
+}
+
+// UTILITIES
+// Map the image at path if its header and checksum match, the caller unmaps length_p bytes
+const char* DesignCache::mapImage(const string& path, const char* magic, unsigned long long key,
+                                  unsigned long long size, ImageHeader* header_p, size_t* length_p){
+    struct stat st;
+    const char* image = NULL;
+    int         fd;
+
+    if((fd = open(path.c_str(), O_RDONLY)) < 0)
+        return NULL;
+    if(fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(*header_p)){
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map != MAP_FAILED){
+            image = (const char*)map;
+            memcpy(header_p, image, sizeof(*header_p));
+            if(memcmp(header_p->magic, magic, sizeof(header_p->magic)) == 0 && header_p->version == VERSION &&
+               header_p->key == key && header_p->size == size &&
+               header_p->numVars >= 0 && header_p->numVars < INT_MAX &&
+               header_p->checksum == hashBytes(image + sizeof(*header_p), st.st_size - sizeof(*header_p)))
+                *length_p = st.st_size;
+            else{
+                munmap(map, st.st_size);
+                image = NULL;
+            }
+        }
+    }
+    close(fd);
+    return image;
+}
+
+// Create the temporary file of an image and write a header, closeImage() completes it
+FILE* DesignCache::openImage(const string& temp, const char* magic, unsigned long long key,
+                             unsigned long long size, int numVars, ImageHeader* header_p){
+    FILE* file;
+
+    if((file = fopen(temp.c_str(), "w+b")) == NULL)
+        return NULL;
+    memset(header_p, 0, sizeof(*header_p));
+    memcpy(header_p->magic, magic, sizeof(header_p->magic));
+    header_p->version = VERSION;
+    header_p->key     = key;
+    header_p->size    = size;
+    header_p->numVars = numVars;
+    fwrite(header_p, sizeof(*header_p), 1, file);
+    return file;
+}
+
+// Checksum the payload as written, fill in the header and rename the file to path
+bool DesignCache::closeImage(FILE* file, ImageHeader* header_p, const string& temp, const string& path){
+    bool ok;
+
+    ok = (fflush(file) == 0) && checksum(fileno(file), sizeof(*header_p), &header_p->checksum) &&
+         fseek(file, 0, SEEK_SET) == 0 && fwrite(header_p, sizeof(*header_p), 1, file) == 1;
+    ok = (ferror(file) == 0) && ok;
+    ok = (fclose(file) == 0) && ok;
+    if(ok && rename(temp.c_str(), path.c_str()) == 0)
+        return true;
+    remove(temp.c_str());
+    return false;
+}
+
+// 64-bit multiply-rotate hash over 8-byte words
+unsigned long long DesignCache::hashBytes(const char* data, size_t size){
+    const unsigned long long K1 = 0x9E3779B97F4A7C15ULL, K2 = 0xC2B2AE3D27D4EB4FULL;
+    unsigned long long h = (size + 1) * K1, w;
+    size_t             i;
+
+    for(i = 0; i + 8 <= size; i += 8){
+        memcpy(&w, data + i, 8);
+        h ^= w * K2;
+        h  = ((h << 31) | (h >> 33)) * K1;
+    }
+    if(i < size){
+        w = 0;
+        memcpy(&w, data + i, size - i);
+        h ^= w * K2;
+        h  = ((h << 31) | (h >> 33)) * K1;
+    }
+    h ^= h >> 33;
+    h *= K2;
+    h ^= h >> 29;
+    return h;
+}
+
+// hashBytes() of the file past offset, false if it cannot be mapped
+bool DesignCache::checksum(int fd, size_t offset, unsigned long long* hash_p){
+    struct stat st;
+
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)offset)
+        return false;
+    if(st.st_size == (off_t)offset){
+        *hash_p = hashBytes(NULL, 0);
+        return true;
+    }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(map == MAP_FAILED)
+        return false;
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+    *hash_p = hashBytes((const char*)map + offset, st.st_size - offset);
+    munmap(map, st.st_size);
+    return true;
+}
+
+// hashBytes() of the file, false if the file is not a regular file (pipes cannot
+// be cached)
+bool DesignCache::hashFile(const char* fileName, unsigned long long* hash_p, unsigned long long* size_p){
+    struct stat st;
+    int         fd;
+    bool        ok;
+
+    if((fd = open(fileName, O_RDONLY)) < 0)
+        return false;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)){
+        close(fd);
+        return false;
+    }
+    *size_p = st.st_size;
+    ok = checksum(fd, 0, hash_p);
+    close(fd);
+    return ok;
+}
@@ -0,0 +1,64 @@
+#ifndef INCLUDED_DESIGN_CACHE
+#define INCLUDED_DESIGN_CACHE
+
+#include <string>
+#include <stdio.h>
+#include "circuit.h"
+#include "coverGroup.h"
+#include "binTemplate.h"
+
+using namespace std;
+
+struct ImageHeader;
+
+// Directory of compiled design images, so repeated jobs skip parsing and CNF generation.
+// A circuit image (netlist, wire classes and gate CNF after ParseCircuit::parse()) is
+// keyed by a content hash of the netlist file and the signature of the cell library.
+// A covergroup image (the parsed covergroup and the CNF of all its bins from
+// BinTemplate::generate()) refers to the variables of the circuit, so it is keyed by
+// the circuit key, a content hash of the covergroup file and the bin CNF mode; jobs
+// with other covergroups on one netlist share the circuit image.
+// A checksum of the image payload in its header rejects damaged images on load.
+// Loading maps the image file and copies its arrays into the objects, then unmaps it.
+// Images are written to a temporary file and renamed, so concurrent jobs can share
+// the directory.
+class DesignCache{
+    private:
+        // Bump whenever the image layout or the circuit or bin CNF encoding changes
+        enum {VERSION = 5};
+
+        // DATA
+        string              d_dir;        // Empty if the cache is off
+        bool                d_hasKey;     // The netlist could be hashed
+        string              d_path;       // Circuit image of the current netlist
+        unsigned long long  d_key;
+        unsigned long long  d_size;       // Netlist size in bytes
+        string              d_coverPath;  // Covergroup image of the current covergroup file
+        unsigned long long  d_coverKey;
+        unsigned long long  d_coverSize;  // Covergroup file size in bytes
+
+    public:
+        // CREATORS
+        DesignCache(const char* dir);    // NULL or "" turns the cache off
+
+        // MANIPULATORS
+        // numVars_p gets the DIMACS variables allocated by the circuit, false on a miss
+        bool load      (const char* netlist, Circuit*, int* numVars_p);
+        void save      (const Circuit&, int numVars);
+        // The covergroup file parsed on the circuit of load(), numVars_p holds the circuit
+        // variables and gets those allocated by the covergroup, false on a miss
+        bool loadCover (const char* coverFile, bool positiveOnly, CoverGroup*, BinTemplate*, int* numVars_p);
+        void saveCover (const CoverGroup&, const BinTemplate&, int numVars);
+
+    private:
+        static const char*        mapImage  (const string& path, const char* magic, unsigned long long key,
+                                             unsigned long long size, ImageHeader* header_p, size_t* length_p);
+        static FILE*              openImage (const string& temp, const char* magic, unsigned long long key,
+                                             unsigned long long size, int numVars, ImageHeader* header_p);
+        static bool               closeImage(FILE*, ImageHeader* header_p, const string& temp, const string& path);
+        static unsigned long long hashBytes (const char* data, size_t size);
+        static bool               checksum  (int fd, size_t offset, unsigned long long* hash_p);
+        static bool               hashFile  (const char* fileName, unsigned long long* hash_p, unsigned long long* size_p);
+};
+
+#endif
@@ -0,0 +1,516 @@
+#include "frameTemplate.h"
+#include <iostream>
+#include <stdlib.h>
+#include <map>
+#include <algorithm>
+
+using namespace std;
+using namespace Minisat;
+
+// Shift a frame relative literal to the frame starting at variable offset
+static inline Lit shiftLit(Lit p, int offset){
+  return toLit( toInt(p) + 2 * offset );
+}
+
+
+// CREATORS
+FrameTemplate::FrameTemplate(){
+  d_numVars  = 0;
+  d_numGates = 0;
+}
+
+// MANIPULATORS
+void FrameTemplate::build(Circuit& circuit, const vector<int>& rootVars, int numVars, bool coi, bool aig, bool renumber){
+  int  outSize, maxVar = numVars;
+  char portChar;
+  Lit  prePPO;
+  vector<pair<int, int> > fanins;
+
+  d_lits.clear();
+  d_clauseBegin.clear();
+  d_latchLits.clear();
+  d_latchBegin.clear();
+  d_clauseBegin.push(0);
+  d_numGates = 0;
+
+  for(int i = 0; i < circuit.wireListSize(); ++i)
+    if(circuit.getCnfVar(i) > maxVar)
+      maxVar = circuit.getCnfVar(i);
+
+  if(aig){
+    Aig graph;
+    if(graph.build(circuit, maxVar)){
+      compileAig(circuit, graph, rootVars, maxVar, coi, &fanins);
+      findDrivenVars(fanins);
+      if(renumber)
+        this->renumber(rootVars, fanins);
+      return;
+    }
+  }
+
+  //////////////////////////////////////////////////////
+  // Mark gates in the cone of influence of the root variables,
+  // flip-flops continue the walk from PPI(t) to PPO(t-1)
+  vector<char> inCone(circuit.gateListSize(), coi ? 0 : 1);
+  vector<char> keep(maxVar + 1, coi ? 0 : 1);
+  if(coi){
+    vector<int> var2wire(maxVar + 1, -1);
+    vector<int> stack;
+    for(int i = 0; i < circuit.wireListSize(); ++i)
+      var2wire.at(circuit.getCnfVar(i)) = i;
+
+    for(int i = 0; i < rootVars.size(); ++i){
+      keep.at(rootVars.at(i)) = 1;
+      if(var2wire.at(rootVars.at(i)) >= 0)
+        stack.push_back(var2wire.at(rootVars.at(i)));
+    }
+    while(!stack.empty()){
+      int gate = circuit.getSourceGate(stack.back());
+      stack.pop_back();
+      if(gate < 0 || inCone.at(gate))
+        continue;
+      inCone.at(gate) = 1;
+      if(circuit.getGateType(gate) == Gate::DFF)
+        stack.push_back(circuit.getInWire(gate, 0));
+      else
+        for(int j = 0; j < circuit.inputSize(gate); ++j)
+          stack.push_back(circuit.getInWire(gate, j));
+    }
+
+    // Keep stimulus variables even if they are out of the cone
+    for(int i = 0; i < circuit.PIListSize(); ++i)
+      keep.at(circuit.getCnfVar(circuit.getPI(i))) = 1;
+    for(int i = 0; i < circuit.RSTListSize(); ++i)
+      keep.at(circuit.getCnfVar(circuit.getRST(i))) = 1;
+    for(int i = 0; i < circuit.gateListSize(); ++i){
+      if(!inCone.at(i)) continue;
+      for(int j = 0; j < circuit.outputSize(i); ++j)
+        keep.at(circuit.getCnfVar(circuit.getOutWire(i, j))) = 1;
+      for(int j = 0; j < circuit.inputSize(i); ++j)
+        keep.at(circuit.getCnfVar(circuit.getInWire(i, j))) = 1;
+    }
+  }
+
+  //////////////////////////////////////////////////////
+  // Number the variables kept in a frame
+  d_varMap.assign(maxVar + 1, -1);
+  d_numVars = 0;
+  for(int v = 1; v <= maxVar; ++v)
+    if(keep.at(v))
+      d_varMap.at(v) = d_numVars++;
+
+  //////////////////////////////////////////////////////
+  // Compile clauses of gates in the cone
+  for(int i = 0; i < circuit.gateListSize(); ++i){
+    if(!inCone.at(i)) continue;
+    const int* gateClause = circuit.getCNFClause(i);
+    if(circuit.cnfSize(i) > 0){
+      ++d_numGates;
+      for(int o = 0; o < circuit.outputSize(i); ++o)
+        for(int j = 0; j < circuit.inputSize(i); ++j)
+          fanins.push_back(make_pair(frameVar(circuit.getCnfVar(circuit.getOutWire(i, o))),
+                                     frameVar(circuit.getCnfVar(circuit.getInWire(i, j)))));
+      for(int j = 0; j < circuit.cnfSize(i); ++j){
+        if(gateClause[j] == 0){
+          d_clauseBegin.push(d_lits.size());
+          continue;
+        }
+        d_lits.push( mkLit( frameVar( abs(gateClause[j]) ), gateClause[j] < 0 ) );
+      }
+    }
+    else if(circuit.getGateType(i) == Gate::DFF){ // Record links of flip-flops
+      ++d_numGates;
+      outSize  = circuit.outputSize(i);
+      portChar = (outSize > 0) ? circuit.getPort(i, 0) : ' ';
+      prePPO   = mkLit( frameVar( circuit.getCnfVar(circuit.getInWire(i, 0)) ) );
+      if(outSize == 1 && (portChar == 'Q' || portChar == 'N')){
+        d_latchLits.push( mkLit( frameVar( circuit.getCnfVar(circuit.getOutWire(i, 0)) ) ) );
+        d_latchLits.push( (portChar == 'Q') ? prePPO : ~prePPO );
+      }
+      else if(outSize == 2 && portChar != circuit.getPort(i, 1)){
+        d_latchLits.push( mkLit( frameVar( circuit.getCnfVar(circuit.getOutWire(i, 0)) ) ) );
+        d_latchLits.push( (portChar == 'Q') ? prePPO : ~prePPO );
+        d_latchLits.push( mkLit( frameVar( circuit.getCnfVar(circuit.getOutWire(i, 1)) ) ) );
+        d_latchLits.push( (portChar == 'Q') ? ~prePPO : prePPO );
+      }
+      else{
+        cout << "Unknown DFF port condition." << endl;
+        cout << "DFF port size = " << outSize << ", port char = " << portChar << endl;
+        exit(1);
+      }
+    }
+  }
+
+  // Every latch link gives two binary clauses
+  for(int i = 0; i <= 2 * d_latchLits.size(); i += 2)
+    d_latchBegin.push(i);
+  findDrivenVars(fanins);
+  if(renumber)
+    this->renumber(rootVars, fanins);
+}
+
+void FrameTemplate::compileAig(Circuit& circuit, const Aig& graph, const vector<int>& rootVars, int maxVar, bool coi,
+                               vector<pair<int, int> >* fanins_p){
+  vector<int>  reqVars;     // DIMACS variables which must have a frame variable
+  vector<int>  nodeSlot(graph.numNodes(), -1);
+  vector<int>  latchOf(graph.numNodes(), -1);
+  vector<char> mark(graph.numNodes(), 0);
+  vector<int>  stack;
+
+  for(int i = 0; i < rootVars.size(); ++i)
+    reqVars.push_back(rootVars.at(i));
+  for(int i = 0; i < circuit.PIListSize(); ++i)
+    reqVars.push_back(circuit.getCnfVar(circuit.getPI(i)));
+  for(int i = 0; i < circuit.RSTListSize(); ++i)
+    reqVars.push_back(circuit.getCnfVar(circuit.getRST(i)));
+  for(int i = 0; i < graph.numLatches(); ++i)
+    latchOf.at(graph.latchNode(i)) = i;
+
+  //////////////////////////////////////////////////////
+  // Mark nodes reaching the required variables,
+  // flip-flops continue the walk from PPI(t) to PPO(t-1).
+  // Without cone-of-influence reduction every wire and flip-flop is kept.
+  for(int i = 0; i < reqVars.size(); ++i)
+    stack.push_back(Aig::node(graph.wireLit(reqVars.at(i))));
+  if(!coi){
+    for(int i = 0; i < circuit.wireListSize(); ++i)
+      stack.push_back(Aig::node(graph.wireLit(circuit.getCnfVar(i))));
+    for(int i = 0; i < graph.numLatches(); ++i)
+      stack.push_back(graph.latchNode(i));
+  }
+  while(!stack.empty()){
+    int n = stack.back();
+    stack.pop_back();
+    if(mark.at(n)) continue;
+    mark.at(n) = 1;
+    if(graph.isAnd(n)){
+      stack.push_back(Aig::node(graph.fanin0(n)));
+      stack.push_back(Aig::node(graph.fanin1(n)));
+    }
+    else if(latchOf.at(n) >= 0)
+      stack.push_back(Aig::node(graph.latchNext(latchOf.at(n))));
+  }
+
+  //////////////////////////////////////////////////////
+  // Group AND nodes for clause emission. Fanin nodes used only once are
+  // absorbed into their fanout: a tree of ANDs becomes one multi-input AND,
+  // and !(s a1) !(!s a0) becomes the multiplexer s ? !a1 : !a0 (XOR/XNOR included).
+  vector<int>  refs(graph.numNodes(), 0);
+  vector<char> absorbed(graph.numNodes(), 0);
+  vector<char> isMux(graph.numNodes(), 0);
+  vector<int>  groupLits;                           // Literals of every emitted group
+  vector<int>  groupBegin(graph.numNodes(), -1);    // groupBegin[n] gives the offset of node n in groupLits
+  for(int i = 0; i < reqVars.size(); ++i)
+    refs.at(Aig::node(graph.wireLit(reqVars.at(i)))) += 2;
+  for(int i = 0; i < graph.numLatches(); ++i)
+    if(mark.at(graph.latchNode(i)))
+      refs.at(Aig::node(graph.latchNext(i))) += 2;
+  if(!coi)
+    for(int i = 0; i < circuit.wireListSize(); ++i)
+      refs.at(Aig::node(graph.wireLit(circuit.getCnfVar(i)))) += 2;
+  for(int n = 1; n < graph.numNodes(); ++n)
+    if(graph.isAnd(n) && mark.at(n)){
+      ++refs.at(Aig::node(graph.fanin0(n)));
+      ++refs.at(Aig::node(graph.fanin1(n)));
+    }
+
+  // Fanins are created before their fanouts, so descending order visits fanouts first
+  for(int n = graph.numNodes() - 1; n > 0; --n){
+    if(!graph.isAnd(n) || !mark.at(n) || absorbed.at(n)) continue;
+    int f0 = graph.fanin0(n), f1 = graph.fanin1(n);
+    int x  = Aig::node(f0), y = Aig::node(f1);
+    groupBegin.at(n) = groupLits.size();
+    if(Aig::isCompl(f0) && Aig::isCompl(f1) && graph.isAnd(x) && graph.isAnd(y) && refs.at(x) == 1 && refs.at(y) == 1){
+      int s = -1, a1 = 0, a0 = 0;
+      if     (graph.fanin0(x) == (graph.fanin0(y) ^ 1)) { s = graph.fanin0(x); a1 = graph.fanin1(x); a0 = graph.fanin1(y); }
+      else if(graph.fanin0(x) == (graph.fanin1(y) ^ 1)) { s = graph.fanin0(x); a1 = graph.fanin1(x); a0 = graph.fanin0(y); }
+      else if(graph.fanin1(x) == (graph.fanin0(y) ^ 1)) { s = graph.fanin1(x); a1 = graph.fanin0(x); a0 = graph.fanin1(y); }
+      else if(graph.fanin1(x) == (graph.fanin1(y) ^ 1)) { s = graph.fanin1(x); a1 = graph.fanin0(x); a0 = graph.fanin0(y); }
+      if(s >= 0){
+        isMux.at(n)    = 1;
+        absorbed.at(x) = 1;
+        absorbed.at(y) = 1;
+        groupLits.push_back(s);
+        groupLits.push_back(a1 ^ 1);
+        groupLits.push_back(a0 ^ 1);
+        continue;
+      }
+    }
+    stack.push_back(f1);
+    stack.push_back(f0);
+    while(!stack.empty()){
+      int f = stack.back();
+      stack.pop_back();
+      if(!Aig::isCompl(f) && graph.isAnd(Aig::node(f)) && refs.at(Aig::node(f)) == 1){
+        absorbed.at(Aig::node(f)) = 1;
+        stack.push_back(graph.fanin1(Aig::node(f)));
+        stack.push_back(graph.fanin0(Aig::node(f)));
+      }
+      else
+        groupLits.push_back(f);
+    }
+  }
+
+  //////////////////////////////////////////////////////
+  // Number the frame: leaves in DIMACS order, the constant, then AND groups
+  vector<int> leafOf(maxVar + 1, -1);
+  for(int n = 1; n < graph.numNodes(); ++n)
+    if(!graph.isAnd(n))
+      leafOf.at(graph.leafVar(n)) = n;
+  d_numVars = 0;
+  for(int v = 1; v <= maxVar; ++v)
+    if(leafOf.at(v) >= 0 && mark.at(leafOf.at(v)))
+      nodeSlot.at(leafOf.at(v)) = d_numVars++;
+  if(mark.at(0)){
+    nodeSlot.at(0) = d_numVars++;
+    d_lits.push( ~mkLit(nodeSlot.at(0)) );
+    d_clauseBegin.push(d_lits.size());
+  }
+  for(int n = 1; n < graph.numNodes(); ++n)
+    if(groupBegin.at(n) >= 0)
+      nodeSlot.at(n) = d_numVars++;
+
+  //////////////////////////////////////////////////////
+  // Group clauses, groups are stored in descending node order
+  for(int n = graph.numNodes() - 1; n > 0; --n){
+    if(groupBegin.at(n) < 0) continue;
+    int begin = groupBegin.at(n);
+    int end   = groupLits.size();
+    for(int m = n - 1; m > 0; --m)
+      if(groupBegin.at(m) >= 0) { end = groupBegin.at(m); break; }
+    ++d_numGates;
+    Lit out = mkLit(nodeSlot.at(n));
+    vector<Lit> in;
+    for(int j = begin; j < end; ++j){
+      in.push_back( mkLit(nodeSlot.at(Aig::node(groupLits.at(j))), Aig::isCompl(groupLits.at(j))) );
+      fanins_p->push_back(make_pair(nodeSlot.at(n), var(in.back())));
+    }
+    if(isMux.at(n)){ // out = in[0] ? in[1] : in[2]
+      d_lits.push(~in[0]); d_lits.push(~in[1]); d_lits.push( out);  d_clauseBegin.push(d_lits.size());
+      d_lits.push(~in[0]); d_lits.push( in[1]); d_lits.push(~out);  d_clauseBegin.push(d_lits.size());
+      d_lits.push( in[0]); d_lits.push(~in[2]); d_lits.push( out);  d_clauseBegin.push(d_lits.size());
+      d_lits.push( in[0]); d_lits.push( in[2]); d_lits.push(~out);  d_clauseBegin.push(d_lits.size());
+    }
+    else{            // out = in[0] & in[1] & ...
+      for(int j = 0; j < in.size(); ++j){
+        d_lits.push(~out); d_lits.push(in[j]);  d_clauseBegin.push(d_lits.size());
+      }
+      d_lits.push(out);
+      for(int j = 0; j < in.size(); ++j)
+        d_lits.push(~in[j]);
+      d_clauseBegin.push(d_lits.size());
+    }
+  }
+
+  //////////////////////////////////////////////////////
+  // Map DIMACS variables to the frame. A required variable whose literal is
+  // complemented or constant gets its own frame variable tied to the literal.
+  d_varMap.assign(maxVar + 1, -1);
+  for(int v = 1; v <= maxVar; ++v){
+    int lit = graph.wireLit(v);
+    if(Aig::node(lit) != 0 && !Aig::isCompl(lit) && nodeSlot.at(Aig::node(lit)) >= 0)
+      d_varMap.at(v) = nodeSlot.at(Aig::node(lit));
+  }
+  for(int i = 0; i < reqVars.size(); ++i){
+    int v = reqVars.at(i);
+    if(d_varMap.at(v) >= 0) continue;
+    int lit = graph.wireLit(v);
+    Lit eq  = mkLit(d_numVars);
+    Lit src = mkLit(nodeSlot.at(Aig::node(lit)), Aig::isCompl(lit));
+    d_varMap.at(v) = d_numVars++;
+    fanins_p->push_back(make_pair(var(eq), var(src)));
+    d_lits.push(~eq); d_lits.push( src);  d_clauseBegin.push(d_lits.size());
+    d_lits.push( eq); d_lits.push(~src);  d_clauseBegin.push(d_lits.size());
+  }
+
+  //////////////////////////////////////////////////////
+  // Latch links of the kept flip-flop outputs
+  for(int i = 0; i < graph.numLatches(); ++i){
+    if(!mark.at(graph.latchNode(i))) continue;
+    ++d_numGates;
+    int next = graph.latchNext(i);
+    d_latchLits.push( mkLit(nodeSlot.at(graph.latchNode(i))) );
+    d_latchLits.push( mkLit(nodeSlot.at(Aig::node(next)), Aig::isCompl(next)) );
+  }
+  for(int i = 0; i <= 2 * d_latchLits.size(); i += 2)
+    d_latchBegin.push(i);
+}
+
+// Register outputs come first, then covergroup bits, then the remaining variables in
+// depth-first post-order of the fanin graph starting from the covergroup bits and
+// the next-state functions. Clause and latch literals follow the new numbering.
+void FrameTemplate::renumber(const vector<int>& rootVars, const vector<pair<int, int> >& fanins){
+  vector<int>  faninBegin(d_numVars + 1, 0);
+  vector<int>  faninVar(fanins.size());
+  vector<int>  newVar(d_numVars, -1);
+  vector<int>  starts;
+  vector<pair<int, int> > stack;   // (variable, next fanin)
+  int          next = 0;
+
+  // Fanin graph in CSR form
+  for(int i = 0; i < fanins.size(); ++i)
+    ++faninBegin.at(fanins[i].first + 1);
+  for(int v = 0; v < d_numVars; ++v)
+    faninBegin[v + 1] += faninBegin[v];
+  vector<int> fill(faninBegin.begin(), faninBegin.end() - 1);
+  for(int i = 0; i < fanins.size(); ++i)
+    faninVar[fill[fanins[i].first]++] = fanins[i].second;
+
+  // Clustered variables
+  for(int i = 0; i < d_latchLits.size(); i += 2)
+    if(newVar[var(d_latchLits[i])] < 0)
+      newVar[var(d_latchLits[i])] = next++;
+  for(int i = 0; i < rootVars.size(); ++i){
+    int v = frameVar(rootVars[i]);
+    if(v >= 0 && newVar[v] < 0)
+      newVar[v] = next++;
+    if(v >= 0)
+      starts.push_back(v);
+  }
+
+  // Depth-first post-order, a variable follows its fanins
+  for(int i = 1; i < d_latchLits.size(); i += 2)
+    starts.push_back(var(d_latchLits[i]));
+  for(int v = 0; v < d_numVars; ++v)
+    starts.push_back(v);
+  vector<char> visited(d_numVars, 0);
+  for(int i = 0; i < starts.size(); ++i){
+    if(visited[starts[i]]) continue;
+    visited[starts[i]] = 1;
+    stack.push_back(make_pair(starts[i], faninBegin[starts[i]]));
+    while(!stack.empty()){
+      int v = stack.back().first;
+      int k = stack.back().second;
+      if(k < faninBegin[v + 1]){
+        ++stack.back().second;
+        if(!visited[faninVar[k]]){
+          visited[faninVar[k]] = 1;
+          stack.push_back(make_pair(faninVar[k], faninBegin[faninVar[k]]));
+        }
+        continue;
+      }
+      if(newVar[v] < 0)
+        newVar[v] = next++;
+      stack.pop_back();
+    }
+  }
+
+  for(int i = 0; i < d_lits.size(); ++i)
+    d_lits[i] = mkLit(newVar[var(d_lits[i])], sign(d_lits[i]));
+
+  // Clauses sorted by their highest variable, so the clauses of a gate stay together
+  // and the clause arena follows the variable order
+  vector<pair<int, int> > key(numClauses());
+  vec<Lit>                lits;
+  vec<int>                clauseBegin;
+  for(int c = 0; c < numClauses(); ++c){
+    key[c] = make_pair(0, c);
+    for(int j = d_clauseBegin[c]; j < d_clauseBegin[c + 1]; ++j)
+      key[c].first = max(key[c].first, var(d_lits[j]));
+  }
+  sort(key.begin(), key.end());
+  lits.capacity(d_lits.size());
+  clauseBegin.push(0);
+  for(int c = 0; c < key.size(); ++c){
+    for(int j = d_clauseBegin[key[c].second]; j < d_clauseBegin[key[c].second + 1]; ++j)
+      lits.push(d_lits[j]);
+    clauseBegin.push(lits.size());
+  }
+  lits.moveTo(d_lits);
+  clauseBegin.moveTo(d_clauseBegin);
+  for(int i = 0; i < d_latchLits.size(); ++i)
+    d_latchLits[i] = mkLit(newVar[var(d_latchLits[i])], sign(d_latchLits[i]));
+  for(int v = 0; v < d_varMap.size(); ++v)
+    if(d_varMap[v] >= 0)
+      d_varMap[v] = newVar[d_varMap[v]];
+  for(int i = 0; i < d_drivenVars.size(); ++i)
+    d_drivenVars[i] = newVar[d_drivenVars[i]];
+}
+
+// Outputs of the fanin graph in topological order, none if the graph has a cycle
+void FrameTemplate::findDrivenVars(const vector<pair<int, int> >& fanins){
+  vector<int> pending(d_numVars, 0);     // Fanins not yet in topological order
+  vector<int> fanoutBegin(d_numVars + 1, 0);
+  vector<int> fanout(fanins.size());
+  vector<int> queue;
+
+  d_drivenVars.clear();
+  for(int i = 0; i < fanins.size(); ++i){
+    ++pending.at(fanins[i].first);
+    ++fanoutBegin.at(fanins[i].second + 1);
+  }
+  for(int v = 0; v < d_numVars; ++v)
+    fanoutBegin[v + 1] += fanoutBegin[v];
+  vector<int> fill(fanoutBegin.begin(), fanoutBegin.end() - 1);
+  for(int i = 0; i < fanins.size(); ++i)
+    fanout[fill[fanins[i].second]++] = fanins[i].first;
+
+  for(int v = 0; v < d_numVars; ++v)
+    if(pending[v] == 0)
+      queue.push_back(v);
+  for(int i = 0; i < queue.size(); ++i)
+    for(int k = fanoutBegin[queue[i]]; k < fanoutBegin[queue[i] + 1]; ++k)
+      if(--pending[fanout[k]] == 0){
+        queue.push_back(fanout[k]);
+        d_drivenVars.push(fanout[k]);
+      }
+  if(queue.size() < d_numVars)
+    d_drivenVars.clear();
+}
+
+// ACCESSORS
+int FrameTemplate::numVars() const{
+  return d_numVars;
+}
+
+int FrameTemplate::numGates() const{
+  return d_numGates;
+}
+
+int FrameTemplate::frameVar(int cnfVar) const{
+  return (cnfVar > 0 && cnfVar < d_varMap.size()) ? d_varMap[cnfVar] : -1;
+}
+
+int FrameTemplate::numClauses() const{
+  return d_clauseBegin.size() - 1;
+}
+
+int FrameTemplate::numLatches() const{
+  return d_latchLits.size() / 2;
+}
+
+bool FrameTemplate::canRestrictDecisions() const{
+  return d_drivenVars.size() > 0;
+}
+
+void FrameTemplate::restrictDecisions(Solver& solver, int frameVar, bool linked) const{
+  if(!canRestrictDecisions())
+    return;
+  for(int i = 0; i < d_drivenVars.size(); ++i)
+    solver.setDecisionVar(frameVar + d_drivenVars[i], false);
+  for(int i = 0; linked && i < d_latchLits.size(); i += 2)
+    solver.setDecisionVar(frameVar + var(d_latchLits[i]), false);
+}
+
+void FrameTemplate::instantiate(Solver& solver, int frameVar, int preFrameVar) const{
+  vec<Lit> lits;
+
+  // Reserve all variables of the frame at once
+  if(solver.nVars() < frameVar + d_numVars)
+    solver.newVars(frameVar + d_numVars - solver.nVars());
+
+  // Gate clauses
+  solver.addClauses(d_lits, d_clauseBegin, frameVar);
+
+  // Connect PPI(t) to PPO(t-1)
+  if(preFrameVar < 0 || d_latchLits.size() == 0)
+    return;
+  lits.capacity(2 * d_latchLits.size());
+  for(int i = 0; i < d_latchLits.size(); i += 2){
+    Lit PPI    = shiftLit(d_latchLits[i], frameVar);
+    Lit prePPO = shiftLit(d_latchLits[i + 1], preFrameVar);
+    lits.push(~PPI); lits.push( prePPO);
+    lits.push( PPI); lits.push(~prePPO);
+  }
+  solver.addClauses(lits, d_latchBegin);
+}
@@ -0,0 +1,70 @@
+#ifndef INCLUDED_FRAME_TEMPLATE
+#define INCLUDED_FRAME_TEMPLATE
+
+#include <vector>
+#include "circuit.h"
+#include "aig.h"
+
+#include "core/Solver.h"
+
+using namespace std;
+using namespace Minisat;
+
+// Circuit CNF of a single time frame, compiled once after Circuit::setCNF().
+// All literals are frame relative (variable 0 is the first variable of the frame),
+// so unrolling frame t only shifts them by the first variable of frame t.
+// Flip-flops are kept apart as latch links PPI(t) == PPO(t-1).
+// With cone-of-influence reduction only gates that can reach a root variable
+// through the fanin graph and the flip-flop links are compiled, and the frame
+// only holds their variables plus the PI/RST variables.
+// With AIG reduction the clauses are emitted from the structurally hashed
+// And-Inverter Graph instead of the gate list, wires that collapse into the
+// same literal share one frame variable.
+// Optionally the frame variables are renumbered for locality: register outputs
+// and covergroup bits first, then a depth-first post-order of the fanin graph,
+// so the inputs and the output of a gate get neighbouring variables.
+class FrameTemplate{
+    private:
+        // DATA
+        int          d_numVars;      // Number of variables reserved by a frame
+        int          d_numGates;     // Number of gates and flip-flops compiled into the frame
+        vector<int>  d_varMap;       // d_varMap[v] gives the frame relative variable of DIMACS variable v, -1 if out of the frame
+        vec<Lit>     d_lits;         // Literals of all gate clauses, frame relative
+        vec<int>     d_clauseBegin;  // Clause i is d_lits[d_clauseBegin[i]] ... d_lits[d_clauseBegin[i+1]-1]
+        vec<Lit>     d_latchLits;    // Pairs of (PPI(t), PPO(t-1)), QN ports are stored as negated PPO
+        vec<int>     d_latchBegin;   // Clause offsets of the two binary clauses of every latch link
+        vec<int>     d_drivenVars;   // Gate outputs, set by propagation once the frame inputs are set; empty with a combinational loop
+
+    public:
+        // CREATORS
+        FrameTemplate();
+
+        // MANIPULATORS
+        // rootVars are the DIMACS variables to be kept (covergroup bits),
+        // numVars is the max DIMACS variable allocated by the parsers
+        void build       (Circuit&, const vector<int>& rootVars, int numVars, bool coi, bool aig, bool renumber = false);
+
+        // ACCESSORS
+        int  numVars     () const;
+        int  numGates    () const;
+        int  frameVar    (int cnfVar) const;     // Frame relative variable of a DIMACS variable, -1 if out of the frame
+        int  numClauses  () const;
+        int  numLatches  () const;
+
+        // Add clauses of a frame starting at frameVar, latch links refer to the frame starting at preFrameVar
+        // (preFrameVar < 0 for frame 0)
+        void instantiate (Solver&, int frameVar, int preFrameVar) const;
+        // Only the frame inputs (PI, RST, PPI of frame 0, undriven wires) of the frame starting at frameVar
+        // stay decision variables, PPI of linked frames follow the previous frame
+        void restrictDecisions (Solver&, int frameVar, bool linked) const;
+        bool canRestrictDecisions () const;     // False if the frame has a combinational loop
+
+    private:
+        // fanins_p gets (output, input) pairs of frame variables for renumber()
+        void compileAig  (Circuit&, const Aig&, const vector<int>& rootVars, int maxVar, bool coi,
+                          vector<pair<int, int> >* fanins_p);
+        void renumber    (const vector<int>& rootVars, const vector<pair<int, int> >& fanins);
+        void findDrivenVars (const vector<pair<int, int> >& fanins);
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <sstream>
+#include <algorithm>
 
 using namespace std;
 
@@ -21,13 +22,7 @@ class Global{
         //int clauseNumber;
         
         static void eraseBlanks(string* str_p){
-            size_t found;
-            string::iterator it;
-      
-            while((found = str_p->find(' ')) != string::npos){
-                it = str_p->begin() + found;
-                str_p->erase(it);
-            }
+            str_p->erase(remove(str_p->begin(), str_p->end(), ' '), str_p->end());
         }
 
         static string int2str(const int i){
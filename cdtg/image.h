@@ -0,0 +1,125 @@
+#ifndef INCLUDED_IMAGE
+#define INCLUDED_IMAGE
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Helpers of the cached images (DesignCache), an image may come from a damaged
+// or foreign file, so every read is bounded by the end of the image.
+
+// Image arrays are a 64-bit element count followed by the elements, padded to 8 bytes
+template<class T>
+inline void writeArray(FILE* file, const vector<T>& array){
+    static const char  zeros[8] = {0};
+    unsigned long long count = array.size();
+    size_t             bytes = count * sizeof(T);
+    fwrite(&count, sizeof(count), 1, file);
+    if(bytes > 0)
+        fwrite(&array[0], 1, bytes, file);
+    fwrite(zeros, 1, (8 - bytes % 8) % 8, file);
+}
+
+template<class T>
+inline bool readArray(const char** pos_p, const char* end, vector<T>* array_p){
+    unsigned long long count;
+    if(end - *pos_p < (long long)sizeof(count))
+        return false;
+    memcpy(&count, *pos_p, sizeof(count));
+    *pos_p += sizeof(count);
+    if(count > (unsigned long long)(end - *pos_p) / sizeof(T))
+        return false;
+    size_t bytes = count * sizeof(T);
+    array_p->resize(count);
+    if(bytes > 0)
+        memcpy(&(*array_p)[0], *pos_p, bytes);
+    *pos_p += bytes + (8 - bytes % 8) % 8;
+    return *pos_p <= end;
+}
+
+// True if every entry is in [lower, upper)
+inline bool inRange(const vector<int>& array, int lower, int upper){
+    for(size_t i = 0; i < array.size(); ++i)
+        if(array[i] < lower || array[i] >= upper)
+            return false;
+    return true;
+}
+
+// True if begin is a CSR offset array over an array of the given size
+inline bool isCsr(const vector<int>& begin, int size){
+    if(begin.empty() || begin[0] != 0 || begin.back() != size)
+        return false;
+    for(size_t i = 1; i < begin.size(); ++i)
+        if(begin[i] < begin[i - 1])
+            return false;
+    return true;
+}
+
+// Fields of the objects of an image, integers and strings are kept in one array
+// each and read back in the order they were put
+class ImageRecord{
+    private:
+        // DATA
+        vector<int>   d_ints;
+        vector<char>  d_chars;     // Strings, each ends with '\0'
+        size_t        d_intPos;
+        size_t        d_charPos;
+
+    public:
+        // CREATORS
+        ImageRecord(){
+            d_intPos  = 0;
+            d_charPos = 0;
+        }
+
+        // MANIPULATORS
+        void put(int value){
+            d_ints.push_back(value);
+        }
+
+        void put(const string& str){
+            d_chars.insert(d_chars.end(), str.begin(), str.end());
+            d_chars.push_back('\0');
+        }
+
+        // False if the record is exhausted or the value is out of [lower, upper)
+        bool get(int* value_p, int lower, int upper){
+            if(d_intPos == d_ints.size())
+                return false;
+            *value_p = d_ints[d_intPos++];
+            return *value_p >= lower && *value_p < upper;
+        }
+
+        bool get(string* str_p){
+            if(d_charPos == d_chars.size())
+                return false;
+            const char* begin = &d_chars[d_charPos];
+            const char* end   = (const char*)memchr(begin, '\0', d_chars.size() - d_charPos);
+            if(end == NULL)
+                return false;
+            str_p->assign(begin, end);
+            d_charPos += end - begin + 1;
+            return true;
+        }
+
+        bool read(const char** pos_p, const char* end){
+            d_intPos  = 0;
+            d_charPos = 0;
+            return readArray(pos_p, end, &d_ints) && readArray(pos_p, end, &d_chars);
+        }
+
+        // ACCESSORS
+        bool done() const{   // True if every field has been read
+            return d_intPos == d_ints.size() && d_charPos == d_chars.size();
+        }
+
+        void write(FILE* file) const{
+            writeArray(file, d_ints);
+            writeArray(file, d_chars);
+        }
+};
+
+#endif
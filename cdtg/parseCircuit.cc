@@ -1,15 +1,15 @@
 #include "parseCircuit.h"
-#include <stdio.h>
 #include <stdlib.h>
-#include <cmath>
-#include <assert.h>
+#include <string.h>
+#include <thread>
+#include <atomic>
 
 // CREATORS
-ParseCircuit::ParseCircuit(Circuit* circuit_p, char* circuitFile, int* cnfVar_p){
+ParseCircuit::ParseCircuit(Circuit* circuit_p, char* circuitFile, int* cnfVar_p, int threads){
     d_circuit_p = circuit_p;
-    d_circuitFile.open(circuitFile, ifstream::in);
     d_cnfVar_p = cnfVar_p;
-    if(!d_circuitFile){
+    d_threads = (threads > 0) ? threads : max(1, (int)thread::hardware_concurrency());
+    if(!d_circuitFile.open(circuitFile)){
         cout << "File could not be opened" << endl;
         exit(1);
     }
@@ -21,32 +21,45 @@ ParseCircuit::ParseCircuit(Circuit* circuit_p, char* circuitFile, int* cnfVar_p)
 // MANIPULATORS
 // MAIN PARSING FUNCTION
 void ParseCircuit::parse(){
-    char c_str[Global::STR_LENGTH];
-    string str, nextstr, substr;
+    long long size      = d_circuitFile.end() - d_circuitFile.begin();
+    int       numChunks = (int)min((long long)d_threads * CHUNKS_PER_THREAD, size / MIN_CHUNK_SIZE);
     
-    while(d_circuitFile.getline(c_str, Global::STR_LENGTH)){
-        str = string(c_str);
-        Global::eraseBlanks(&str);
-        if(str.length()==0) continue;
-        substr = str.substr(0, 4);
-        if(substr.compare("inpu")==0 || substr.compare("outp")==0 || substr.compare("wire")==0){
-            parseWires(str);
-        }
-        else if(substr.compare("modu")!=0 && substr.compare("endm")!=0){// Not module neither endmodule
-            // Formalize strings of gate cells so every string ends with a ';'
-            formalizeGateLine(&str);
-            parseGates(str);
+    // Tokenize the chunks, a chunk boundary inside a statement or a comment
+    // falls back to a single chunk
+    splitChunks(max(numChunks, 1));
+    runChunks(&ParseCircuit::parseChunk);
+    for(int i = 0; i < (int)d_chunks.size() - 1; ++i)
+        if(!d_chunks.at(i).complete){
+            splitChunks(1);
+            runChunks(&ParseCircuit::parseChunk);
+            break;
         }
+    for(int i = 0; i < d_chunks.size(); ++i){
+        cout << d_chunks.at(i).log;
+        d_chunks.at(i).log.clear();
     }
+    
+    // Wires in file order
+    for(int i = 0; i < d_chunks.size(); ++i)
+        addWires(d_chunks.at(i));
   
+    // Create connection between wires and gates
+    // cout << "Creating gate conneciton..." << endl;
+    runChunks(&ParseCircuit::connectChunk);
+    for(int i = 0; i < d_chunks.size(); ++i){
+        cout << d_chunks.at(i).log;
+        if(!d_chunks.at(i).error.empty()){
+            cout << d_chunks.at(i).error << endl;
+            exit(1);
+        }
+        addGates(d_chunks.at(i));
+    }
+    d_chunks.clear();
+    
     // Create IO pseudo-gates
     // cout << "Creating io connection..." << endl;
     createInoutGates();
     
-    // Create connection between wires and gates
-    // cout << "Creating gate conneciton..." << endl;
-    gateConnection();
-    
     // Classify wires
     // cout << "Classifying wires..." << endl;
     d_circuit_p->classifyWire();
@@ -100,359 +113,379 @@ void ParseCircuit::initializeGateTypeMap(){
     d_gateTypeMap[(string)"AOI21"]   = Gate::AOI21;
 }
 
-void ParseCircuit::formalizeGateLine(string* str_p){
-    char c_str[Global::STR_LENGTH];
-    string nextstr;
+// Chunks end after a line ending with ';'
+void ParseCircuit::splitChunks(int numChunks){
+    const char* begin = d_circuitFile.begin();
+    const char* end   = d_circuitFile.end();
+    const char* pos   = begin;
     
-    while(str_p->at(str_p->length() - 1) != ';'){
-        d_circuitFile.getline(c_str, Global::STR_LENGTH);
-        nextstr = string(c_str);
-        Global::eraseBlanks(&nextstr);
-        (*str_p) += nextstr;
-        assert(str_p->length() < str_p->max_size());
-    }  
+    d_chunks.assign(numChunks, Chunk());
+    for(int i = 0; i < numChunks; ++i){
+        const char* bound = (i == numChunks - 1) ? end : max(pos, begin + (end - begin) / numChunks * (i + 1));
+        while(bound != end){
+            const char* eol  = (const char*)memchr(bound, '\n', end - bound);
+            const char* last = eol;
+            if(eol == NULL){
+                bound = end;
+                break;
+            }
+            while(last != begin && (last[-1] == ' ' || last[-1] == '\t' || last[-1] == '\r'))
+                --last;
+            bound = eol + 1;
+            if(last != begin && last[-1] == ';')
+                break;
+        }
+        d_chunks.at(i).begin = pos;
+        d_chunks.at(i).end   = bound;
+        pos = bound;
+    }
 }
 
-void ParseCircuit::parseWires(string str){
-    char    c_str[Global::STR_LENGTH];
-    string  substr, intstr, tempstr;
-    size_t  tail = 0, mid = 0, high = 0, low = 0;
-    int     h, l;
-    bool    isInput = false, passEnd = false;
-    Wire::wireType type;
-      
-    // Recognize the type of wire
-    substr = str.substr(0, 4);
-    if(substr.compare("inpu")==0){
-        type = Wire::PI;
-        str.erase(0, 5);// Erase "input"
-        isInput = true;
-    }
-    else if(substr.compare("outp")==0){
-        type = Wire::PO;
-        str.erase(0, 6);// Erase "output"
-    }
-    else{
-        type = Wire::NORMAL;
-        str.erase(0, 4);// Erase "wire"
-    }
+void ParseCircuit::runChunks(void (ParseCircuit::*work)(Chunk*)){
+    int            numThreads = min(d_threads, (int)d_chunks.size());
+    atomic<int>    nextChunk(0);
+    vector<thread> pool;
     
-    passEnd = false;
-    while(!passEnd){
-        while(str.length() != 0){
-            if((tail = str.find_first_of(',')) == string::npos){
-                tail = str.length() - 1;
-                passEnd = true;
-                assert(str.at(tail) == ';');
-            }
-            substr = str.substr(0, tail);
-            // Handle [H:L], add a vector of wires
-            if(substr.at(0)=='['){
-                mid    = substr.find_first_of(']');
-                high   = 1;
-                low    = substr.find_first_of(':');
-                intstr = substr.substr(high, low-high+1);
-                h      = atoi(intstr.c_str());
-                high   = low+1;
-                low    = mid-1;
-                intstr = substr.substr(high, low-high+1);
-                l      = atoi(intstr.c_str());
-          
-                substr.erase(0, mid+1);
-                for(int i = l; i <= h; ++i){
-                    tempstr =  substr;
-                    intstr  =  Global::int2str(i);
-                    tempstr += '[';
-                    tempstr += intstr;
-                    tempstr += ']';
-                    Wire* wire_p = new Wire(tempstr, type, ++(*d_cnfVar_p));
-                    d_circuit_p->addWire(wire_p);
-                }
-            }
-            else{ // Add a single wire
-//              cout << "Add new wire: \"" << substr << endl;
-              if(isInput){
-                  size_t find;
-                  if((find = substr.find("clk")) != string::npos || (find = substr.find("CLK")) != string::npos ||
-                     (find = substr.find("clock")) != string::npos || (find = substr.find("CLOCK")) != string::npos)
-                    type = Wire::CLK;
-                  else if((find = substr.find("rst")) != string::npos   || (find = substr.find("RST")) != string::npos   ||
-                          (find = substr.find("reset")) != string::npos || (find = substr.find("RESET")) != string::npos)
-                    type = Wire::RST;
-                  else
-                    type = Wire::PI;
-              }
-              Wire* wire_p = new Wire(substr, type, ++(*d_cnfVar_p));
-              d_circuit_p->addWire(wire_p);
-            }
-            str.erase(0, tail+1);
-      }
-      
-      if(!passEnd){
-          d_circuitFile.getline(c_str, Global::STR_LENGTH);
-          str = string(c_str);
-          Global::eraseBlanks(&str);
-      }
+    if(numThreads <= 1){
+        for(int i = 0; i < d_chunks.size(); ++i)
+            (this->*work)(&d_chunks.at(i));
+        return;
     }
+    for(int t = 0; t < numThreads; ++t)
+        pool.push_back(thread([this, work, &nextChunk](){
+            for(int i; (i = nextChunk++) < (int)d_chunks.size(); )
+                (this->*work)(&d_chunks.at(i));
+        }));
+    for(int t = 0; t < numThreads; ++t)
+        pool.at(t).join();
 }
 
-void ParseCircuit::parseGates(string str){
-  Gate::gateType type;
-  static int gateId = 1;
-
-  type = getGateType(str);
-  // Store the string for further handle
-  Gate* gate_p = new Gate(type, str, gateId);
-  d_circuit_p->addGate(gate_p);
-  gateId++;
+void ParseCircuit::parseChunk(Chunk* chunk_p){
+    Tokenizer        tokenizer;
+    Tokenizer::Token token;
+    
+    tokenizer.attach(chunk_p->begin, chunk_p->end);
+    chunk_p->complete = true;
+    while(tokenizer.next(&token)){
+        if(token.is("input"))
+            chunk_p->complete = parseWires(tokenizer, chunk_p, Wire::PI);
+        else if(token.is("output"))
+            chunk_p->complete = parseWires(tokenizer, chunk_p, Wire::PO);
+        else if(token.is("wire"))
+            chunk_p->complete = parseWires(tokenizer, chunk_p, Wire::NORMAL);
+        else if(token.is("module"))
+            chunk_p->complete = tokenizer.skipPast(';');
+        else if(!token.is("endmodule"))
+            chunk_p->complete = parseGates(tokenizer, chunk_p, token);
+    }
+    if(tokenizer.openComment())
+        chunk_p->complete = false;
 }
 
-void ParseCircuit::createInoutGates(){
-  int gateId = d_circuit_p->gateListSize() + 1;
-  
-  for(int i=0;i<d_circuit_p->PIListSize();++i){
-    Gate* gate_p = new Gate(Gate::INPUT, gateId++);
-    gate_p->addOutWire(d_circuit_p->getPI(i));
-    d_circuit_p->addGate(gate_p);
-  }
-  for(int i=0;i<d_circuit_p->POListSize();++i){
-    Gate* gate_p = new Gate(Gate::OUTPUT, gateId++);
-    gate_p->addInWire(d_circuit_p->getPO(i));
-    d_circuit_p->addGate(gate_p);
-  }  
-  for(int i=0;i<d_circuit_p->CLKListSize();++i){
-    Gate* gate_p = new Gate(Gate::INPUT, gateId++);
-    //gate_p->setHasClkOrRst(true);
-    gate_p->addOutWire(d_circuit_p->getCLK(i));
-    d_circuit_p->addGate(gate_p);
-  }
-  for(int i=0;i<d_circuit_p->RSTListSize();++i){
-    Gate* gate_p = new Gate(Gate::INPUT, gateId++);
-    //gate_p->setHasClkOrRst(true);
-    gate_p->addOutWire(d_circuit_p->getRST(i));
-    d_circuit_p->addGate(gate_p);
-  }
+// False if the declaration runs past the end of the chunk
+bool ParseCircuit::parseWires(Tokenizer& tokenizer, Chunk* chunk_p, Wire::wireType declType){
+    Tokenizer::Token token, high, low;
+    WireDecl         decl;
+    
+    decl.isBus = false;
+    decl.high  = 0;
+    decl.low   = 0;
+    while(tokenizer.next(&token)){
+        if(token.is(';'))
+            return true;
+        if(token.is(',') || token.is("wire") || token.is("reg"))
+            continue;
+        // Handle [H:L], the range applies to every following name
+        if(token.is('[')){
+            tokenizer.next(&high);
+            tokenizer.next(&token); // ':'
+            tokenizer.next(&low);
+            tokenizer.next(&token); // ']'
+            decl.high  = high.toInt();
+            decl.low   = low.toInt();
+            decl.isBus = true;
+            continue;
+        }
+        decl.name = token;
+        decl.type = declType;
+        if(declType == Wire::PI && !decl.isBus){
+            if(token.contains("clk") || token.contains("CLK") || token.contains("clock") || token.contains("CLOCK"))
+                decl.type = Wire::CLK;
+            else if(token.contains("rst") || token.contains("RST") || token.contains("reset") || token.contains("RESET"))
+                decl.type = Wire::RST;
+        }
+        chunk_p->wires.push_back(decl);
+    }
+    return false;
 }
 
-void ParseCircuit::gateConnection(){
-  string         str, wireName;
-  char           portChar;
-  size_t         found;
-  bool           output;               // used to identify output port
-  Gate::gateType gtype;
-  vector<Wire>::iterator wit;
+// Only the position of the statement is kept, it is read again by connectChunk()
+bool ParseCircuit::parseGates(Tokenizer& tokenizer, Chunk* chunk_p, const Tokenizer::Token& first){
+    Tokenizer::Token token;
+    Gate::gateType   type = Gate::BUF;
+    int              cell = -1;
+    bool             complete = false;
     
-  for(int i = 0; i < d_circuit_p->gateListSize(); ++i){
-    gtype = d_circuit_p->getGate(i)->getType();
-// cout << "Utility: " << d_circuit_p->getGate(i)->getUtilityStr() << endl;
-    if(gtype == Gate::CONST0 || gtype == Gate::CONST1){
-      str = d_circuit_p->getGate(i)->getUtilityStr();
-      // We assume "assign wire_out = constant"
-      // Identify output wire
-      str.erase(0, 6); // Erase "assign" in the front
-      found = str.find_first_of('=');
-      wireName = str.substr(0, found);
-      // Connect output wire to gate
-      for(int j = 0; j < d_circuit_p->wireListSize(); ++j){
-        if(wireName.compare(d_circuit_p->getWire(j)->getName()) == 0){
-          d_circuit_p->getGate(i)->addOutWire(d_circuit_p->getWire(j));                                                                            
-          d_circuit_p->getWire(j)->setSourceGate(d_circuit_p->getGate(i));
-          break;
+    if(first.is("assign")){
+        // "assign wire_out = wire_in" is a buffer, "assign wire_out = N'b0" a constant
+        while(!complete && tokenizer.next(&token)){
+            if(token.contains("'b0"))
+                type = Gate::CONST0;
+            else if(token.contains("'b1"))
+                type = Gate::CONST1;
+            complete = token.is(';');
         }
-        if(j == (d_circuit_p->wireListSize() - 1)){
-          cout << __FILE__ << "::" << __LINE__ <<  ": Cannot find wire: " << wireName << endl;
-          exit(1);
+    }
+    else{
+        type = getGateType(first, &cell, &chunk_p->log);
+        complete = tokenizer.skipPast(';');
+    }
+    chunk_p->gates.push_back(make_pair(type, first.str));
+    chunk_p->gateCell.push_back(cell);
+    return complete;
+}
+
+void ParseCircuit::addWires(const Chunk& chunk){
+    string name;
+    
+    for(int i = 0; i < chunk.wires.size(); ++i){
+        const WireDecl& decl = chunk.wires.at(i);
+        if(decl.isBus){ // Add a vector of wires
+            for(int j = decl.low; j <= decl.high; ++j){
+                name.assign(decl.name.str, decl.name.length);
+                name += '[';
+                name += Global::int2str(j);
+                name += ']';
+                d_circuit_p->addWire(name, decl.type, ++(*d_cnfVar_p));
+            }
         }
+        else // Add a single wire
+            d_circuit_p->addWire(decl.name.str, decl.name.length, decl.type, ++(*d_cnfVar_p));
+    }
+}
+
+// Resolves the pins of every gate statement of the chunk, stops at the first unknown wire.
+// Pins of library cells are matched by name and stored in library pin order.
+void ParseCircuit::connectChunk(Chunk* chunk_p){
+  const CellLibrary* library_p = d_circuit_p->getLibrary();
+  Tokenizer        tokenizer;
+  Tokenizer::Token token, instance, port, wireName;
+  char             portChar;
+  bool             output;               // used to identify output port
+  bool             last;
+  Gate::gateType   gtype;
+  int              cell, numInputs, pinIndex;
+  int              wire;
+  int              cellPin[CellLibrary::MAX_INPUTS + CellLibrary::MAX_OUTPUTS];
+    
+  tokenizer.attach(chunk_p->begin, chunk_p->end);
+  chunk_p->pinBegin.push_back(0);
+  for(int i = 0; i < chunk_p->gates.size(); ++i){
+    gtype = chunk_p->gates.at(i).first;
+    cell  = chunk_p->gateCell.at(i);
+    tokenizer.setPosition(chunk_p->gates.at(i).second);
+    tokenizer.next(&token);
+    if(token.is("assign")){
+      // "assign wire_out = constant" or a pseudo buffer for "assign wire_out = wire_in"
+      getWireName(tokenizer, chunk_p, &wireName);
+      if((wire = findWire(wireName, chunk_p)) < 0)
+        return;
+      chunk_p->pinWire.push_back(wire);
+      chunk_p->pinPort.push_back('Y');
+      tokenizer.next(&token); // '='
+      if(gtype == Gate::BUF){
+        getWireName(tokenizer, chunk_p, &wireName);
+        if((wire = findWire(wireName, chunk_p)) < 0)
+          return;
+        chunk_p->pinWire.push_back(wire);
+        chunk_p->pinPort.push_back(0);
       }
+      chunk_p->pinBegin.push_back(chunk_p->pinWire.size());
+      continue;
     }
-    else if(gtype == Gate::BUF){
-      bool isAssign = false;
-      str = d_circuit_p->getGate(i)->getUtilityStr();
-      // Identify output wire
-      if(str.substr(0, 6).compare("assign") == 0){
-        // Here buffer means a pseudo buffer for "assign wire_out = wire_in"
-        isAssign = true;
-        str.erase(0, 6); // Erase "assign" in the front
-        found = str.find_first_of('=');
-        wireName = str.substr(0, found);
+    
+    // CELL instance ( .PORT(wire), ... );
+    tokenizer.next(&instance);
+    if(!instance.is('('))
+      tokenizer.next(&token);
+    numInputs = (gtype == Gate::CELL) ? library_p->numInputs(cell) : 0;
+    if(gtype == Gate::CELL)
+      for(int j = 0; j < numInputs + library_p->numOutputs(cell); ++j)
+        cellPin[j] = -1;
+    for(int pin = 0; tokenizer.next(&token) && token.is('.'); ++pin){
+      tokenizer.next(&port);
+      tokenizer.next(&token); // '('
+      bool named = getWireName(tokenizer, chunk_p, &wireName);
+      tokenizer.next(&token); // ')'
+      tokenizer.next(&token); // ',' or the ')' closing the last pin
+      last = !token.is(',');
+      
+      // The first pin of a buffer cell and the last pin of other cells drive the output,
+      // flip-flops drive only .Q and .QN
+      portChar = 'Y';
+      output   = (gtype == Gate::BUF) ? (pin == 0) : last;
+      if(gtype == Gate::DFF){
+        output = port.is("Q") || port.is("QN");
+        if(output)
+          portChar = port.is("Q") ? 'Q' : 'N';
       }
-      else{
-        found = str.find_first_of('.');
-        str.erase(0, found);
-        wireName = getWireName(d_circuit_p->getGate(i)->getType(), &str, &portChar, &output);
+      pinIndex = -1;
+      if(gtype == Gate::CELL && (pinIndex = library_p->findPin(cell, port.str, port.length)) < 0){
+        if(chunk_p->error.empty())
+          chunk_p->error = "Cell " + library_p->cellName(cell) + " has no pin " + port.toString() + " in gate: " + instance.toString();
+        return;
       }
-      // Connect output wire to gate
-      for(int j = 0; j < d_circuit_p->wireListSize(); ++j){
-        if(wireName.compare(d_circuit_p->getWire(j)->getName()) == 0){
-          d_circuit_p->getGate(i)->addOutWire(d_circuit_p->getWire(j));                                                                            
-          d_circuit_p->getWire(j)->setSourceGate(d_circuit_p->getGate(i));
-          break;
-        }
-        if(j == (d_circuit_p->wireListSize() - 1)){
-          cout << __FILE__ << "::" << __LINE__ <<  ": Cannot find wire: " << wireName << endl;
-          exit(1);
-        }
-      }
-      // Identify input wire
-      if(isAssign){
-        str.erase(0, found + 1);
-        str.erase(str.length() - 1, 1);
-        wireName = str;
+      
+      if(!named){
+        chunk_p->log += "Warning !!! Empty port name in gate: " + instance.toString() + "\n";
+        continue;
       }
-      else{
-        found = str.find_first_of('.');
-        str.erase(0, found);
-        wireName = getWireName(d_circuit_p->getGate(i)->getType(), &str, &portChar, &output);
+      else if(wireName.is("1'b0") || wireName.is("1'b1")){
+        chunk_p->log += "Warning !!! Constant port name in gate: " + instance.toString() + "\n";
+        continue;
       }
-      // Connect input wire to gate
-      for(int j = 0; j < d_circuit_p->wireListSize(); ++j){
-        if(wireName.compare(d_circuit_p->getWire(j)->getName()) == 0){
-          d_circuit_p->getGate(i)->addInWire(d_circuit_p->getWire(j));                                                                          
-          d_circuit_p->getWire(j)->addDestGate(d_circuit_p->getGate(i));
-          break;
-        }
-        if(j == (d_circuit_p->wireListSize() - 1)){
-          cout << __FILE__ << "::" << __LINE__ <<  ": Cannot find wire: " << wireName << endl;
-          exit(1);
-        }
+      
+      if((wire = findWire(wireName, chunk_p)) < 0)
+        return;
+      if(pinIndex >= 0){
+        cellPin[pinIndex] = wire;
+        continue;
       }
+      chunk_p->pinWire.push_back(wire);
+      chunk_p->pinPort.push_back(output ? portChar : 0);
     }
-    else{
-      str = d_circuit_p->getGate(i)->getUtilityStr();
-      found = str.find_first_of('.');
-      str.erase(0, found);
-      
-      // Set wire connections
-      while(str.length() != 0){
-        output = false;
-        wireName = getWireName(d_circuit_p->getGate(i)->getType(), &str, &portChar, &output);
-        //assert(!wireName.empty());
-        if(wireName.empty()){
-            cout << "Warning !!! Empty port name in gate: " << d_circuit_p->getGate(i)->getUtilityStr() << endl;
-            continue;
-        }
-        else if(wireName.compare("1'b0") == 0 || wireName.compare("1'b1") == 0){
-            cout << "Warning !!! Constant port name in gate: " << d_circuit_p->getGate(i)->getUtilityStr() << endl;
-            continue;
+    
+    // Every input of a cell must be connected, outputs may be left open
+    if(gtype == Gate::CELL){
+      for(int j = 0; j < numInputs + library_p->numOutputs(cell); ++j){
+        if(j < numInputs && cellPin[j] < 0){
+          if(chunk_p->error.empty())
+            chunk_p->error = "Input " + library_p->pinName(cell, j) + " of cell " + library_p->cellName(cell) +
+                             " is not connected in gate: " + instance.toString();
+          return;
         }
-        
-        for(int j = 0; j < d_circuit_p->wireListSize(); ++j){
-          if(wireName.compare(d_circuit_p->getWire(j)->getName()) == 0){
-            if(output){
-              d_circuit_p->getGate(i)->addOutWire(d_circuit_p->getWire(j));  
-              if(portChar == 'Q' || portChar == 'N')
-                d_circuit_p->getGate(i)->addDFFOutPort(portChar);
-              d_circuit_p->getWire(j)->setSourceGate(d_circuit_p->getGate(i));
-            }
-            else{
-              d_circuit_p->getGate(i)->addInWire(d_circuit_p->getWire(j));
-              d_circuit_p->getWire(j)->addDestGate(d_circuit_p->getGate(i));
-            }
-            
-            // Identify clk and rst 
-            // if(d_circuit_p->getWire(j)->getType() == Wire::CLK || d_circuit_p->getWire(j)->getType() == Wire::RST){
-            //   d_circuit_p->getGate(i)->setHasClkOrRst(true);
-            // }
-            break;
-          }
-          if(j == d_circuit_p->wireListSize() - 1){
-            cout << __FILE__ << "::" << __LINE__ <<  ": Cannot find wire: " << wireName << endl;
-            exit(1);
-          }
-        }//end for
-      }//end while
-      
-      // Change wire type of PPI and PPO
-      if(d_circuit_p->getGate(i)->getType() == Gate::DFF){
-        for(int j = 0; j < d_circuit_p->getGate(i)->outputSize(); ++j)
-          d_circuit_p->getGate(i)->getOutWire(j)->setWireType(Wire::PPI);
-        if(d_circuit_p->getGate(i)->getInWire(0)->getType() != Wire::PI)
-          d_circuit_p->getGate(i)->getInWire(0)->setWireType(Wire::PPO);
+        if(cellPin[j] < 0)
+          continue;
+        chunk_p->pinWire.push_back(cellPin[j]);
+        chunk_p->pinPort.push_back((j < numInputs) ? 0 : '0' + j - numInputs);
       }
     }
+    chunk_p->pinBegin.push_back(chunk_p->pinWire.size());
+  }
+}
+
+void ParseCircuit::addGates(const Chunk& chunk){
+  Gate::gateType gtype;
+  int            gate;
+  
+  for(int i = 0; i < chunk.gates.size(); ++i){
+    gtype = chunk.gates.at(i).first;
+    gate  = d_circuit_p->addGate(gtype, chunk.gateCell.at(i));
+    for(int j = chunk.pinBegin.at(i); j < chunk.pinBegin.at(i + 1); ++j){
+      if(chunk.pinPort.at(j) != 0)
+        d_circuit_p->addOutWire(chunk.pinWire.at(j), chunk.pinPort.at(j));
+      else
+        d_circuit_p->addInWire(chunk.pinWire.at(j));
+    }
+    
+    // Change wire type of PPI and PPO
+    if(gtype == Gate::DFF){
+      for(int j = 0; j < d_circuit_p->outputSize(gate); ++j)
+        d_circuit_p->setWireType(d_circuit_p->getOutWire(gate, j), Wire::PPI);
+      if(d_circuit_p->getWireType(d_circuit_p->getInWire(gate, 0)) != Wire::PI)
+        d_circuit_p->setWireType(d_circuit_p->getInWire(gate, 0), Wire::PPO);
+    }
+  }
+}
+
+// Pseudo-gates of IO are added after the gates of the netlist
+void ParseCircuit::createInoutGates(){
+  for(int i=0;i<d_circuit_p->PIListSize();++i){
+    d_circuit_p->addGate(Gate::INPUT);
+    d_circuit_p->addOutWire(d_circuit_p->getPI(i));
+  }
+  for(int i=0;i<d_circuit_p->POListSize();++i){
+    d_circuit_p->addGate(Gate::OUTPUT);
+    d_circuit_p->addInWire(d_circuit_p->getPO(i));
+  }  
+  for(int i=0;i<d_circuit_p->CLKListSize();++i){
+    d_circuit_p->addGate(Gate::INPUT);
+    d_circuit_p->addOutWire(d_circuit_p->getCLK(i));
+  }
+  for(int i=0;i<d_circuit_p->RSTListSize();++i){
+    d_circuit_p->addGate(Gate::INPUT);
+    d_circuit_p->addOutWire(d_circuit_p->getRST(i));
   }
 }
 
-Gate::gateType ParseCircuit::getGateType(string str){
+// Messages go to log_p, the function is called from several threads.
+// Gate types come first, then cells of the library (CELL with *cell_p set).
+Gate::gateType ParseCircuit::getGateType(const Tokenizer::Token& cell, int* cell_p, string* log_p) const{
+    const CellLibrary* library_p = d_circuit_p->getLibrary();
     Gate::gateType type = Gate::UNKNOWN;
-    map<string, Gate::gateType>::iterator it;
+    map<string, Gate::gateType>::const_iterator it;
     size_t found;
+    string str = cell.toString();
   
-    //cout << "Original string =\"" << str << "\"" << endl;
-    if(str.substr(0, 6).compare("assign") == 0){
-        if(str.find("'b0") != string::npos) // N'b0
-            type = Gate::CONST0;
-        else if(str.find("'b1") != string::npos) // N'b1
-            type = Gate::CONST1;
-        else
-          type = Gate::BUF;
-    }
-    else if((found = str.find_last_of('X')) != string::npos){
+    *cell_p = -1;
+    if(library_p != NULL && (*cell_p = library_p->findCell(str)) >= 0)
+        return Gate::CELL;
+    
+    // Strip the drive strength, e.g. AND2X1 is AND2
+    if((found = str.find_last_of('X')) != string::npos){
         str.erase(found, str.length() - found);
-        if((it = d_gateTypeMap.find(str)) != d_gateTypeMap.end()){
-            //cout << "Add gate of type:" << str << endl;
-            type = d_gateTypeMap[str];
-        }
-        else{ // Keep searching
-            while((it = d_gateTypeMap.find(str)) == d_gateTypeMap.end()){
-                found = str.find_last_of('X');
-                if(found == string::npos){ // Cannot find anymore 'X', no such gate
-                    cout << "Cannot find gate type: " << str << endl;
-                    break;
-                }
-                else{
-                    str.erase(found, str.length() - found);
-                    //cout << "Identify gate type from string:\"" << str << "\"" << endl;
-                }
+        while((it = d_gateTypeMap.find(str)) == d_gateTypeMap.end()){
+            if(library_p != NULL && (*cell_p = library_p->findCell(str)) >= 0)
+                return Gate::CELL;
+            found = str.find_last_of('X');
+            if(found == string::npos){ // Cannot find anymore 'X', no such gate
+                *log_p += "Cannot find gate type: " + str + "\n";
+                break;
             }
-            //cout << "Add gate of type:" << str << endl;
-            type = d_gateTypeMap[str];
+            str.erase(found, str.length() - found);
         }
+        // Cells of no known type are connected as buffers
+        type = (it != d_gateTypeMap.end()) ? it->second : Gate::BUF;
     }
 
     if(type == Gate::UNKNOWN)
-        cout << __FILE__ << ":" << __LINE__ << ": Unknown gate type from spec" << str << endl;
+        *log_p += string(__FILE__) + ":" + Global::int2str(__LINE__) + ": Unknown gate type from spec" + str + "\n";
       
     return type;
 }
 
-string ParseCircuit::getWireName(Gate::gateType gType, string* str_p, char* c_p, bool* output_p){
-    string wireName, portName;
-    size_t point, head, tail;
+// Reads a wire reference NAME or NAME[i], false if the connection is empty
+bool ParseCircuit::getWireName(Tokenizer& tokenizer, Chunk* chunk_p, Tokenizer::Token* name_p) const{
+    Tokenizer::Token token, index;
     
-    (*c_p) = 'Y';
-    head = str_p->find_first_of('(');
-    if(head != string::npos){
-        tail = str_p->find_first_of(')');
-        wireName = str_p->substr(head + 1, tail - head - 1);
-        
-        point = str_p->find_first_of('.');
-        portName = str_p->substr(point + 1, head - point - 1);
-        
-        str_p->erase(0, tail + 1);
+    if(!tokenizer.peek(&token) || token.is(')') || token.is(',') || token.is(';') || token.is('=')){
+        name_p->str    = "";
+        name_p->length = 0;
+        return false;
     }
-    
-    // Check .Q and .QN
-    if(gType == Gate::DFF){
-        if(portName.compare("Q") == 0){
-          (*c_p) = 'Q';
-          (*output_p) = true;
-          //cout << "Wire: " << wireName << ", port = Q" << endl;
-        }
-        else if(portName.compare("QN") == 0){
-          (*c_p) = 'N';
-          (*output_p) = true;
-          //cout << "Wire: " << wireName << ", port = QN" << endl;
+    tokenizer.next(name_p);
+    if(tokenizer.peek(&token) && token.is('[')){
+        tokenizer.next(&token);
+        tokenizer.next(&index);
+        tokenizer.next(&token); // ']'
+        if(token.str + 1 - name_p->str == name_p->length + index.length + 2)
+            name_p->length = token.str + 1 - name_p->str;
+        else{ // Blanks inside the reference
+            chunk_p->nameBuffer.assign(name_p->str, name_p->length);
+            chunk_p->nameBuffer += '[';
+            chunk_p->nameBuffer.append(index.str, index.length);
+            chunk_p->nameBuffer += ']';
+            name_p->str    = chunk_p->nameBuffer.data();
+            name_p->length = chunk_p->nameBuffer.length();
         }
     }
-    
-    // Check remain in/out
-    head = str_p->find_first_of('(');
-    if(head == string::npos){
-        str_p->clear();
-        (*output_p) = true;
-    }
-    
-    return wireName;
+    return true;
 }
 
+// -1 if the wire cannot be found, the first one is reported by parse()
+int ParseCircuit::findWire(const Tokenizer::Token& wireName, Chunk* chunk_p) const{
+  int wire = d_circuit_p->findWire(wireName.str, wireName.length);
+  if(wire < 0 && chunk_p->error.empty())
+    chunk_p->error = string(__FILE__) + "::" + Global::int2str(__LINE__) + ": Cannot find wire: " + wireName.toString();
+  return wire;
+}
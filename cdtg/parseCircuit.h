@@ -3,8 +3,8 @@
 
 #include "global.h"
 #include "circuit.h"
+#include "tokenizer.h"
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <vector>
 #include <map>
@@ -12,17 +12,46 @@
 
 using namespace std;
 
+// The netlist is split into chunks at statement boundaries, chunks are tokenized
+// and their gates are connected on a pool of threads. Wires and gates are then
+// added to the circuit in file order, so wire indices and CNF variables do not
+// depend on the number of threads.
 class ParseCircuit{
     private:
+        enum {MIN_CHUNK_SIZE = 1 << 20, CHUNKS_PER_THREAD = 4};
+        
+        struct WireDecl{
+          Tokenizer::Token name;
+          Wire::wireType   type;
+          bool             isBus;
+          int              high, low;
+        };
+        struct Chunk{
+          const char*      begin;
+          const char*      end;
+          bool             complete;    // False if a statement or a block comment runs past the end
+          vector<WireDecl> wires;
+          vector<pair<Gate::gateType, const char*> > gates;   // Gate statements (file positions)
+          vector<int>      gateCell;    // Library cell of CELL gates, -1 otherwise
+          vector<int>      pinBegin;    // Pins of gate i are pinWire[pinBegin[i]] ... pinWire[pinBegin[i+1]-1]
+          vector<int>      pinWire;
+          vector<char>     pinPort;     // Port char of output pins, 0 for input pins
+          string           log;         // Warnings, printed in file order
+          string           error;       // First wire that cannot be found
+          string           nameBuffer;  // Wire names that are not contiguous in the file
+        };
+        
         // DATA
         Circuit*                    d_circuit_p;
-        ifstream                    d_circuitFile;
+        Tokenizer                   d_circuitFile;
         int*                        d_cnfVar_p; // Used for wires, increase variable before set
+        int                         d_threads;
         map<string, Gate::gateType> d_gateTypeMap;
+        vector<Chunk>               d_chunks;
         
     public:
         // CREATORS
-        ParseCircuit(Circuit*, char*, int*);
+        ParseCircuit(Circuit*, char*, int*, int threads = 1);   // threads = 0: one per core
         
         // MANIPULATORS
         // MAIN PARSING FUNCTION
@@ -31,13 +60,18 @@ class ParseCircuit{
     private:
         // UTILITIES
         void            initializeGateTypeMap ();
-        void            formalizeGateLine     (string*);
-        void            parseWires            (string);
-        void            parseGates            (string);
+        void            splitChunks           (int numChunks);
+        void            runChunks             (void (ParseCircuit::*)(Chunk*));
+        void            parseChunk            (Chunk*);
+        void            connectChunk          (Chunk*);
+        bool            parseWires            (Tokenizer&, Chunk*, Wire::wireType);
+        bool            parseGates            (Tokenizer&, Chunk*, const Tokenizer::Token&);
+        void            addWires              (const Chunk&);
+        void            addGates              (const Chunk&);
         void            createInoutGates      ();
-        void            gateConnection        ();
-        Gate::gateType  getGateType           (string);
-        string          getWireName           (Gate::gateType, string*, char*, bool*);
+        Gate::gateType  getGateType           (const Tokenizer::Token&, int* cell_p, string* log_p) const;
+        bool            getWireName           (Tokenizer&, Chunk*, Tokenizer::Token*) const;
+        int             findWire              (const Tokenizer::Token&, Chunk*) const;
 };
 
 #endif
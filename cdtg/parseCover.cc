@@ -8,8 +8,7 @@ ParseCover::ParseCover(Circuit* circuit_p, CoverGroup* coverGroup_p, char* cover
   d_circuit_p = circuit_p;
   d_coverGroup_p = coverGroup_p;
   d_cnfVar_p = cnfVar_p;
-  d_coverFile.open(coverFile, ifstream::in);
-  if(!d_coverFile){
+  if(!d_coverFile.open(coverFile)){
     cout << "File could not be opened" << endl;
     exit(1);
   }
@@ -18,13 +17,9 @@ ParseCover::ParseCover(Circuit* circuit_p, CoverGroup* coverGroup_p, char* cover
 // MANIPULATORS
 // MAIN PARSING FUNCTION
 void ParseCover::parse(){
-  char   cStr[Global::STR_LENGTH];
   string str;
   
-  while(d_coverFile.getline(cStr, Global::STR_LENGTH)){
-    assert(d_coverFile.gcount() < Global::STR_LENGTH);
-    str = string(cStr);
-    Global::eraseBlanks(&str);
+  while(d_coverFile.getLine(&str)){
     if(!str.empty()){
       switch(parseTypeAnalysis(str)){
         case VARIABLE:
@@ -77,7 +72,7 @@ ParseCover::parseType ParseCover::parseTypeAnalysis(const string& str){
 
 void ParseCover::parseVariable(string* str_p){
   size_t find1, find2;
-  string subStr, name, cname;
+  string subStr, name;
   int bitwidth, h, l;
   CoverVariable::varType type;
   	
@@ -127,24 +122,15 @@ void ParseCover::parseVariable(string* str_p){
   int bitDigit;
   int cnfVar = -1;
   if(type == CoverVariable::PI){
-    for(int i = 0; i < d_circuit_p->PIListSize(); ++i){
-    	subStr = d_circuit_p->getPI(i)->getName();
-    	if((find1 = subStr.find_first_of('[')) != string::npos)
-    		cname = subStr.substr(0, find1);
-    	else
-    		cname = subStr;
-      if(name.compare(cname) == 0){
-        if((find1 = subStr.find_first_of('[')) == string::npos) 
-        	bitDigit = 0; // 1-bit
-        else{
-          find2 = subStr.find_first_of(']');
-          assert(find2 != string::npos);
-          bitDigit = Global::str2int(subStr.substr(find1 + 1, find2 - find1 - 1));
-        }
-        cnfVar = d_circuit_p->getPI(i)->getCnfVar();
-        var_p->setCnfVar(bitDigit, cnfVar);
-//        cout << "Set CNF var of variable: " << name << ", CNF var = " << cnfVar << endl;
-      }
+    // A single bit PI has the name of the variable, bits of a bus are named name[i]
+    for(int i = -1; i < bitwidth; ++i){
+      int wire = d_circuit_p->findWire((i < 0) ? name : name + '[' + Global::int2str(i) + ']');
+      if(wire < 0 || d_circuit_p->getWireType(wire) != Wire::PI)
+        continue;
+      bitDigit = (i < 0) ? 0 : i;
+      cnfVar = d_circuit_p->getCnfVar(wire);
+      var_p->setCnfVar(bitDigit, cnfVar);
+//      cout << "Set CNF var of variable: " << name << ", CNF var = " << cnfVar << endl;
     }
     if(cnfVar == -1){
     	cout << __FILE__ << ":" << __LINE__<< ": Cannot find PI: " << name << endl;
@@ -152,24 +138,14 @@ void ParseCover::parseVariable(string* str_p){
     }
   }
   else if(type == CoverVariable::PPI){
-    for(int i = 0; i < d_circuit_p->PPIListSize(); ++i){
-      subStr = d_circuit_p->getPPI(i)->getName();
-      if((find1 = subStr.find_first_of('[')) != string::npos)
-    		cname = subStr.substr(0, find1);
-    	else
-    		cname = subStr;
-      if(name.compare(cname) == 0){
-        if((find1 = subStr.find_first_of('[')) == string::npos) 
-        	bitDigit = 0;  // 1-bit 
-        else{
-          find2 = subStr.find_first_of(']');
-          assert(find2 != string::npos);
-          bitDigit = Global::str2int(subStr.substr(find1 + 1, find2 - find1 - 1));
-        }
-        cnfVar = d_circuit_p->getPPI(i)->getCnfVar();
-        var_p->setCnfVar(bitDigit, cnfVar);
-//        cout << "Set CNF var of variable: " << name << ", CNF var = " << cnfVar << endl;
-      }
+    for(int i = -1; i < bitwidth; ++i){
+      int wire = d_circuit_p->findWire((i < 0) ? name : name + '[' + Global::int2str(i) + ']');
+      if(wire < 0 || d_circuit_p->getWireType(wire) != Wire::PPI)
+        continue;
+      bitDigit = (i < 0) ? 0 : i;
+      cnfVar = d_circuit_p->getCnfVar(wire);
+      var_p->setCnfVar(bitDigit, cnfVar);
+//      cout << "Set CNF var of variable: " << name << ", CNF var = " << cnfVar << endl;
     }
     if(cnfVar == -1){
     	cout << __FILE__ << ":" << __LINE__<< "Cannot find PPI: " << name << endl;
@@ -196,7 +172,6 @@ void ParseCover::parseGroup(string* str_p){
 }
 
 void ParseCover::parsePoint(string* str_p){
-  char           cStr[Global::STR_LENGTH];
   bool           noSpecifyBins = false;
   size_t         find;
   string         str, name, varName;
@@ -327,11 +302,7 @@ void ParseCover::parsePoint(string* str_p){
   }
   else{// Parse user-specified bins
     while(1){
-      d_coverFile.getline(cStr, Global::STR_LENGTH);
-      assert(d_coverFile.gcount()<Global::STR_LENGTH);
-      str = string(cStr);
-      Global::eraseBlanks(&str);
-      if(str[0] == '}') break;
+      if(!d_coverFile.getLine(&str) || str[0] == '}') break;
       // Parsing bins
       parseBin(point_p, &str, var_p); // Call the bins-parsing function
     }
@@ -507,7 +478,6 @@ void ParseCover::parseBin(CoverPoint* point_p, string* str_p, CoverVariable* var
 }
 
 void ParseCover::parseCross(string* str_p){
-  char   cStr[Global::STR_LENGTH];
   bool   noSpecifyBins = false;
   size_t find;
   string str, tempStr, name, spec;  
@@ -581,19 +551,10 @@ void ParseCover::parseCross(string* str_p){
   }
   else{
     while(1){
-      d_coverFile.getline(cStr, Global::STR_LENGTH);
-      assert(d_coverFile.gcount() < Global::STR_LENGTH);
-      str = string(cStr);
-      Global::eraseBlanks(&str);
-      if(str[0] == '}') break;      
+      if(!d_coverFile.getLine(&str) || str[0] == '}') break;      
       // Combine multiple line specification
-      while(str[str.size()-1] != ';'){
-        d_coverFile.getline(cStr, Global::STR_LENGTH);
-        assert(d_coverFile.gcount() < Global::STR_LENGTH);
-        tempStr = string(cStr);
-        Global::eraseBlanks(&tempStr);
+      while(str[str.size()-1] != ';' && d_coverFile.getLine(&tempStr))
         str += tempStr;
-      }
       parseCrossBin(cross_p, &str);     
     }
   }
@@ -1,10 +1,10 @@
 #ifndef INCLUDED_PARSE_COVER
 #define INCLUDED_PARSE_COVER
 
-#include <fstream>
 #include <vector>
 #include <set>
 #include "global.h"
+#include "tokenizer.h"
 #include "coverGroup.h"
 #include "circuit.h"
 
@@ -18,7 +18,7 @@ class ParseCover{
     // DATA
     Circuit*    d_circuit_p;
     CoverGroup* d_coverGroup_p;
-    ifstream    d_coverFile;
+    Tokenizer   d_coverFile;
     int*        d_cnfVar_p; // Only used for local variables
     
   public:
@@ -0,0 +1,559 @@
+#include "simulator.h"
+#include "coverGroup.h"
+#include "coverVariable.h"
+#include <iostream>
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIM_X86
+#endif
+
+using namespace std;
+
+static const SimWord ALL_LANES = ~(SimWord)0;
+
+//////////////////////////////////////////////////////
+// Block kernels, all gates of a block have the same type.
+// Inputs follow Circuit::setCNF(), MX2 is (A, B, S0).
+
+typedef void (*BlockKernel)(int type, int begin, int end, const int* out, const int* faninBegin,
+                            const int* fanin, SimWord* v, int words);
+
+static void evalBlockScalar(int type, int begin, int end, const int* out, const int* faninBegin,
+                            const int* fanin, SimWord* v, int words){
+  SimWord x[4], y;
+  for(int g = begin; g < end; ++g){
+    const int* f = fanin + faninBegin[g];
+    int        n = faninBegin[g + 1] - faninBegin[g];
+    for(int k = 0; k < words; ++k){
+      for(int i = 0; i < n && i < 4; ++i)
+        x[i] = v[f[i] * words + k];
+      switch(type){
+        case Gate::BUF:    y =  x[0];                                break;
+        case Gate::INV:    y = ~x[0];                                break;
+        case Gate::AND2:   y =  x[0] & x[1];                         break;
+        case Gate::AND3:   y =  x[0] & x[1] & x[2];                  break;
+        case Gate::OR2:    y =  x[0] | x[1];                         break;
+        case Gate::OR3:    y =  x[0] | x[1] | x[2];                  break;
+        case Gate::NAND2:  y = ~(x[0] & x[1]);                       break;
+        case Gate::NAND3:  y = ~(x[0] & x[1] & x[2]);                break;
+        case Gate::NAND4:  y = ~(x[0] & x[1] & x[2] & x[3]);         break;
+        case Gate::NOR2:   y = ~(x[0] | x[1]);                       break;
+        case Gate::NOR3:   y = ~(x[0] | x[1] | x[2]);                break;
+        case Gate::XOR2:   y =  x[0] ^ x[1];                         break;
+        case Gate::XNOR2:  y = ~(x[0] ^ x[1]);                       break;
+        case Gate::MX2:    y = (x[2] & x[1]) | (~x[2] & x[0]);       break;
+        case Gate::OAI21:  y = ~((x[0] | x[1]) & x[2]);              break;
+        case Gate::AOI21:  y = ~((x[0] & x[1]) | x[2]);              break;
+        case Gate::CONST0: y = 0;                                    break;
+        case Gate::CONST1: y = ALL_LANES;                            break;
+        default: cout << "Gate type is not in the simulation library" << endl;
+                 exit(1);
+      }
+      v[out[g] * words + k] = y;
+    }
+  }
+}
+
+#ifdef SIM_X86
+__attribute__((target("avx2")))
+static void evalBlockAvx2(int type, int begin, int end, const int* out, const int* faninBegin,
+                          const int* fanin, SimWord* v, int words){
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  __m256i       x[4], y;
+  for(int g = begin; g < end; ++g){
+    const int* f = fanin + faninBegin[g];
+    int        n = faninBegin[g + 1] - faninBegin[g];
+    for(int k = 0; k < words; k += 4){
+      for(int i = 0; i < n && i < 4; ++i)
+        x[i] = _mm256_loadu_si256((const __m256i*)(v + f[i] * words + k));
+      switch(type){
+        case Gate::BUF:    y = x[0];                                                                     break;
+        case Gate::INV:    y = _mm256_xor_si256(x[0], ones);                                             break;
+        case Gate::AND2:   y = _mm256_and_si256(x[0], x[1]);                                             break;
+        case Gate::AND3:   y = _mm256_and_si256(_mm256_and_si256(x[0], x[1]), x[2]);                     break;
+        case Gate::OR2:    y = _mm256_or_si256(x[0], x[1]);                                              break;
+        case Gate::OR3:    y = _mm256_or_si256(_mm256_or_si256(x[0], x[1]), x[2]);                       break;
+        case Gate::NAND2:  y = _mm256_xor_si256(_mm256_and_si256(x[0], x[1]), ones);                     break;
+        case Gate::NAND3:  y = _mm256_xor_si256(_mm256_and_si256(_mm256_and_si256(x[0], x[1]), x[2]), ones); break;
+        case Gate::NAND4:  y = _mm256_xor_si256(_mm256_and_si256(_mm256_and_si256(x[0], x[1]),
+                                                                 _mm256_and_si256(x[2], x[3])), ones);   break;
+        case Gate::NOR2:   y = _mm256_xor_si256(_mm256_or_si256(x[0], x[1]), ones);                      break;
+        case Gate::NOR3:   y = _mm256_xor_si256(_mm256_or_si256(_mm256_or_si256(x[0], x[1]), x[2]), ones); break;
+        case Gate::XOR2:   y = _mm256_xor_si256(x[0], x[1]);                                             break;
+        case Gate::XNOR2:  y = _mm256_xor_si256(_mm256_xor_si256(x[0], x[1]), ones);                     break;
+        case Gate::MX2:    y = _mm256_or_si256(_mm256_and_si256(x[2], x[1]), _mm256_andnot_si256(x[2], x[0])); break;
+        case Gate::OAI21:  y = _mm256_xor_si256(_mm256_and_si256(_mm256_or_si256(x[0], x[1]), x[2]), ones); break;
+        case Gate::AOI21:  y = _mm256_xor_si256(_mm256_or_si256(_mm256_and_si256(x[0], x[1]), x[2]), ones); break;
+        case Gate::CONST0: y = _mm256_setzero_si256();                                                   break;
+        case Gate::CONST1: y = ones;                                                                     break;
+        default: cout << "Gate type is not in the simulation library" << endl;
+                 exit(1);
+      }
+      _mm256_storeu_si256((__m256i*)(v + out[g] * words + k), y);
+    }
+  }
+}
+
+// Three input functions use one ternary logic instruction,
+// the immediate is the truth table over (a, b, c) = (0xF0, 0xCC, 0xAA)
+__attribute__((target("avx512f")))
+static void evalBlockAvx512(int type, int begin, int end, const int* out, const int* faninBegin,
+                            const int* fanin, SimWord* v, int words){
+  __m512i x[4], y;
+  for(int g = begin; g < end; ++g){
+    const int* f = fanin + faninBegin[g];
+    int        n = faninBegin[g + 1] - faninBegin[g];
+    for(int k = 0; k < words; k += 8){
+      for(int i = 0; i < n && i < 4; ++i)
+        x[i] = _mm512_loadu_si512((const void*)(v + f[i] * words + k));
+      switch(type){
+        case Gate::BUF:    y = x[0];                                                              break;
+        case Gate::INV:    y = _mm512_ternarylogic_epi64(x[0], x[0], x[0], 0x0F);                 break;
+        case Gate::AND2:   y = _mm512_and_si512(x[0], x[1]);                                      break;
+        case Gate::AND3:   y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0x80);                 break;
+        case Gate::OR2:    y = _mm512_or_si512(x[0], x[1]);                                       break;
+        case Gate::OR3:    y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0xFE);                 break;
+        case Gate::NAND2:  y = _mm512_ternarylogic_epi64(x[0], x[1], x[1], 0x3F);                 break;
+        case Gate::NAND3:  y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0x7F);                 break;
+        case Gate::NAND4:  y = _mm512_ternarylogic_epi64(_mm512_and_si512(x[0], x[1]), x[2], x[3], 0x7F); break;
+        case Gate::NOR2:   y = _mm512_ternarylogic_epi64(x[0], x[1], x[1], 0x03);                 break;
+        case Gate::NOR3:   y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0x01);                 break;
+        case Gate::XOR2:   y = _mm512_xor_si512(x[0], x[1]);                                      break;
+        case Gate::XNOR2:  y = _mm512_ternarylogic_epi64(x[0], x[1], x[1], 0xC3);                 break;
+        case Gate::MX2:    y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0xD8);                 break;  // c ? b : a
+        case Gate::OAI21:  y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0x57);                 break;
+        case Gate::AOI21:  y = _mm512_ternarylogic_epi64(x[0], x[1], x[2], 0x15);                 break;
+        case Gate::CONST0: y = _mm512_setzero_si512();                                            break;
+        case Gate::CONST1: y = _mm512_set1_epi64(-1);                                             break;
+        default: cout << "Gate type is not in the simulation library" << endl;
+                 exit(1);
+      }
+      _mm512_storeu_si512((void*)(v + out[g] * words + k), y);
+    }
+  }
+}
+#endif
+
+// Gates evaluated by the kernels, all other gates drive level 0 nets
+static inline bool combinational(Gate::gateType type){
+  return type != Gate::DFF && type != Gate::INPUT && type != Gate::OUTPUT && type != Gate::UNKNOWN;
+}
+
+// CREATORS
+Simulator::Simulator(){
+  d_words     = 1;
+  d_kernel    = SCALAR;
+  d_numLevels = 0;
+  d_library_p = NULL;
+  d_nR        = false;
+  d_bias      = 0;
+  d_frame     = 0;
+  d_rngState  = 0x9E3779B97F4A7C15ULL;
+}
+
+// MANIPULATORS
+bool Simulator::build(Circuit& circuit, CoverGroup* coverGroup_p, bool nR, simKernel kernel){
+  int maxVar = 0;
+  d_nR = nR;
+
+  // Widest supported kernel not above the requested one
+  d_kernel = (kernel == AUTO) ? AVX512 : kernel;
+  while(!kernelSupported(d_kernel))
+    d_kernel = (simKernel)(d_kernel - 1);
+  d_words  = (d_kernel == AVX512) ? 8 : (d_kernel == AVX2) ? 4 : 1;
+
+  //////////////////////////////////////////////////////
+  // One net per wire, net i is wire i of the circuit
+  for(int i = 0; i < circuit.wireListSize(); ++i)
+    if(circuit.getCnfVar(i) > maxVar)
+      maxVar = circuit.getCnfVar(i);
+  for(int i = 0; i < coverGroup_p->numOfVariable(); ++i)
+    for(int j = 0; j < coverGroup_p->getVariable(i)->getBitwidth(); ++j)
+      if(coverGroup_p->getVariable(i)->getCnfVar(j) > maxVar)
+        maxVar = coverGroup_p->getVariable(i)->getCnfVar(j);
+  d_netOfVar.assign(maxVar + 1, -1);
+  for(int i = 0; i < circuit.wireListSize(); ++i)
+    d_netOfVar.at(circuit.getCnfVar(i)) = i;
+  d_value.assign(circuit.wireListSize() * d_words, 0);
+
+  //////////////////////////////////////////////////////
+  // Levelize combinational gates, nets without a combinational driver are level 0
+  vector<int>   netLevel(circuit.wireListSize(), -1);
+  vector<char>  onStack(circuit.wireListSize(), 0);
+  vector<int>   stack;
+  vector<int>   gateLevel(circuit.gateListSize(), -1);
+  int           maxLevel = 0;
+  for(int i = 0; i < circuit.wireListSize(); ++i){
+    stack.push_back(i);
+    while(!stack.empty()){
+      int net  = stack.back();
+      int gate = circuit.getSourceGate(net);
+      if(netLevel.at(net) >= 0){
+        stack.pop_back();
+        continue;
+      }
+      if(gate < 0 || !combinational(circuit.getGateType(gate))){
+        netLevel.at(net) = 0;
+        stack.pop_back();
+        continue;
+      }
+      if(!onStack.at(net)){
+        onStack.at(net) = 1;
+        for(int j = 0; j < circuit.inputSize(gate); ++j){
+          int in = circuit.getInWire(gate, j);
+          if(onStack.at(in) && netLevel.at(in) < 0){
+            cout << "Combinational loop through wire " << circuit.getWireName(in) << ", simulation disabled." << endl;
+            return false;
+          }
+          if(netLevel.at(in) < 0)
+            stack.push_back(in);
+        }
+        continue;
+      }
+      int level = 0;
+      for(int j = 0; j < circuit.inputSize(gate); ++j)
+        if(netLevel.at(circuit.getInWire(gate, j)) > level)
+          level = netLevel.at(circuit.getInWire(gate, j));
+      netLevel.at(net) = level + 1;
+      stack.pop_back();
+    }
+  }
+  for(int i = 0; i < circuit.gateListSize(); ++i){
+    if(!combinational(circuit.getGateType(i)) || circuit.outputSize(i) == 0)
+      continue;
+    gateLevel.at(i) = 1;
+    for(int j = 0; j < circuit.inputSize(i); ++j)
+      if(netLevel.at(circuit.getInWire(i, j)) + 1 > gateLevel.at(i))
+        gateLevel.at(i) = netLevel.at(circuit.getInWire(i, j)) + 1;
+    if(gateLevel.at(i) > maxLevel)
+      maxLevel = gateLevel.at(i);
+  }
+
+  //////////////////////////////////////////////////////
+  // Sort gates by level, then by type, and cut blocks of one type
+  const int   numTypes = Gate::UNKNOWN + 1;
+  vector<int> keyBegin((maxLevel + 1) * numTypes + 1, 0);
+  for(int i = 0; i < circuit.gateListSize(); ++i)
+    if(gateLevel.at(i) >= 0)
+      ++keyBegin.at(gateLevel.at(i) * numTypes + circuit.getGateType(i) + 1);
+  for(int key = 1; key < keyBegin.size(); ++key)
+    keyBegin.at(key) += keyBegin.at(key - 1);
+  vector<int> order(keyBegin.back());
+  vector<int> fill(keyBegin.begin(), keyBegin.end() - 1);
+  for(int i = 0; i < circuit.gateListSize(); ++i)
+    if(gateLevel.at(i) >= 0)
+      order.at(fill.at(gateLevel.at(i) * numTypes + circuit.getGateType(i))++) = i;
+
+  // Library cells are evaluated once per connected output
+  d_library_p = circuit.getLibrary();
+  d_blockType.clear();
+  d_blockBegin.clear();
+  d_gateOut.clear();
+  d_gateCover.clear();
+  d_fanin.clear();
+  d_faninBegin.assign(1, 0);
+  for(int key = 0; key + 1 < keyBegin.size(); ++key){
+    if(keyBegin.at(key) == keyBegin.at(key + 1)) continue;
+    d_blockType.push_back(key % numTypes);
+    d_blockBegin.push_back(d_gateOut.size());
+    for(int k = keyBegin.at(key); k < keyBegin.at(key + 1); ++k){
+      int gate = order.at(k);
+      int outs = (circuit.getGateType(gate) == Gate::CELL) ? circuit.outputSize(gate) : 1;
+      for(int o = 0; o < outs; ++o){
+        d_gateOut.push_back(circuit.getOutWire(gate, o));
+        d_gateCover.push_back((circuit.getGateType(gate) == Gate::CELL) ?
+                              d_library_p->output(circuit.getCell(gate), circuit.getPort(gate, o) - '0') : -1);
+        for(int j = 0; j < circuit.inputSize(gate); ++j)
+          d_fanin.push_back(circuit.getInWire(gate, j));
+        d_faninBegin.push_back(d_fanin.size());
+      }
+    }
+  }
+  d_blockBegin.push_back(d_gateOut.size());
+  d_numLevels = order.empty() ? 0 : maxLevel;
+
+  //////////////////////////////////////////////////////
+  // Flip-flops
+  d_ppiNet.clear();
+  d_ppoNet.clear();
+  d_ppiInv.clear();
+  for(int i = 0; i < circuit.dffListSize(); ++i){
+    int gate = circuit.getDFF(i);
+    for(int j = 0; j < circuit.outputSize(gate); ++j){
+      char portChar = circuit.getPort(gate, j);
+      if(portChar != 'Q' && portChar != 'N'){
+        cout << "Unknown DFF port condition." << endl;
+        cout << "DFF port size = " << circuit.outputSize(gate) << ", port char = " << portChar << endl;
+        exit(1);
+      }
+      d_ppiNet.push_back(circuit.getOutWire(gate, j));
+      d_ppoNet.push_back(circuit.getInWire(gate, 0));
+      d_ppiInv.push_back(portChar == 'N');
+    }
+  }
+  d_nextState.assign(d_ppiNet.size() * d_words, 0);
+
+  d_piNet.clear();
+  d_rstNet.clear();
+  for(int i = 0; i < circuit.PIListSize(); ++i)
+    d_piNet.push_back(circuit.getPI(i));
+  for(int i = 0; i < circuit.RSTListSize(); ++i)
+    d_rstNet.push_back(circuit.getRST(i));
+
+  //////////////////////////////////////////////////////
+  // Nets of covergroup variables
+  d_varNets.clear();
+  for(int i = 0; i < coverGroup_p->numOfVariable(); ++i){
+    CoverVariable* var_p = coverGroup_p->getVariable(i);
+    vector<int>&   nets  = d_varNets[var_p];
+    for(int j = 0; j < var_p->getBitwidth(); ++j)
+      nets.push_back(d_netOfVar.at(var_p->getCnfVar(j)));
+  }
+
+  reset();
+  return true;
+}
+
+void Simulator::seed(SimWord s){
+  d_rngState = (s != 0) ? s : 0x9E3779B97F4A7C15ULL;
+}
+
+void Simulator::setBias(int bias){
+  d_bias = bias;
+}
+
+void Simulator::loadState(int lane, const vector<char>& state){
+  d_loadState.push_back(make_pair(lane, state));
+}
+
+void Simulator::loadPI(int lane, const vector<char>& piBits){
+  d_loadPI.push_back(make_pair(lane, piBits));
+}
+
+void Simulator::reset(){
+  for(int i = 0; i < d_value.size(); ++i)
+    d_value[i] = 0;
+  for(int i = 0; i < d_rstNet.size(); ++i)
+    for(int k = 0; k < d_words; ++k)
+      d_value[d_rstNet[i] * d_words + k] = d_nR ? 0 : ALL_LANES;
+  d_loadState.clear();
+  d_loadPI.clear();
+  d_frame = 0;
+  evaluate();
+}
+
+void Simulator::step(){
+  // Sample all PPO before any PPI changes, a PPI may feed another flip-flop directly
+  for(int i = 0; i < d_ppiNet.size(); ++i)
+    for(int k = 0; k < d_words; ++k)
+      d_nextState[i * d_words + k] = d_ppiInv[i] ? ~d_value[d_ppoNet[i] * d_words + k] : d_value[d_ppoNet[i] * d_words + k];
+  for(int j = 0; j < d_loadState.size(); ++j){
+    int     lane = d_loadState[j].first;
+    SimWord bit  = (SimWord)1 << (lane % LANES);
+    for(int i = 0; i < d_ppiNet.size(); ++i){
+      SimWord& w = d_nextState[i * d_words + lane / LANES];
+      w = d_loadState[j].second.at(i) ? (w | bit) : (w & ~bit);
+    }
+  }
+  d_loadState.clear();
+  for(int i = 0; i < d_ppiNet.size(); ++i)
+    for(int k = 0; k < d_words; ++k)
+      d_value[d_ppiNet[i] * d_words + k] = d_nextState[i * d_words + k];
+  for(int i = 0; i < d_piNet.size(); ++i)
+    for(int k = 0; k < d_words; ++k){
+      SimWord r = random();
+      if(d_bias < 0)      r &= random();
+      else if(d_bias > 0) r |= random();
+      d_value[d_piNet[i] * d_words + k] = r;
+    }
+  for(int j = 0; j < d_loadPI.size(); ++j){
+    int     lane = d_loadPI[j].first;
+    SimWord bit  = (SimWord)1 << (lane % LANES);
+    for(int i = 0; i < d_piNet.size(); ++i){
+      SimWord& w = d_value[d_piNet[i] * d_words + lane / LANES];
+      w = d_loadPI[j].second.at(i) ? (w | bit) : (w & ~bit);
+    }
+  }
+  d_loadPI.clear();
+  for(int i = 0; i < d_rstNet.size(); ++i)
+    for(int k = 0; k < d_words; ++k)
+      d_value[d_rstNet[i] * d_words + k] = d_nR ? ALL_LANES : 0;
+  ++d_frame;
+  evaluate();
+}
+
+void Simulator::evaluate(){
+  BlockKernel kernel = evalBlockScalar;
+#ifdef SIM_X86
+  if(d_kernel == AVX512) kernel = evalBlockAvx512;
+  if(d_kernel == AVX2)   kernel = evalBlockAvx2;
+#endif
+  if(d_gateOut.empty())
+    return;
+  for(int b = 0; b + 1 < d_blockBegin.size(); ++b){
+    if(d_blockType[b] == Gate::CELL)
+      evaluateCells(d_blockBegin[b], d_blockBegin[b + 1]);
+    else
+      kernel(d_blockType[b], d_blockBegin[b], d_blockBegin[b + 1], &d_gateOut[0], &d_faninBegin[0],
+             d_fanin.empty() ? 0 : &d_fanin[0], &d_value[0], d_words);
+  }
+}
+
+// Sum of products over the smaller cover of each cell output
+void Simulator::evaluateCells(int begin, int end){
+  SimWord x[CellLibrary::MAX_INPUTS], y, term;
+  for(int g = begin; g < end; ++g){
+    const int*               f     = &d_fanin[0] + d_faninBegin[g];
+    int                      n     = d_faninBegin[g + 1] - d_faninBegin[g];
+    int                      out   = d_gateCover[g];
+    bool                     onSet = d_library_p->coverSize(out, true) <= d_library_p->coverSize(out, false);
+    int                      size  = d_library_p->coverSize(out, onSet);
+    const CellLibrary::Cube* cube  = d_library_p->getCover(out, onSet);
+    for(int k = 0; k < d_words; ++k){
+      for(int i = 0; i < n; ++i)
+        x[i] = d_value[f[i] * d_words + k];
+      y = 0;
+      for(int c = 0; c < size; ++c){
+        term = ALL_LANES;
+        for(int i = 0; i < n; ++i)
+          if((cube[c].mask >> i) & 1)
+            term &= ((cube[c].value >> i) & 1) ? x[i] : ~x[i];
+        y |= term;
+      }
+      d_value[d_gateOut[g] * d_words + k] = onSet ? y : ~y;
+    }
+  }
+}
+
+// xorshift64*
+SimWord Simulator::random(){
+  d_rngState ^= d_rngState >> 12;
+  d_rngState ^= d_rngState << 25;
+  d_rngState ^= d_rngState >> 27;
+  return d_rngState * 2685821657736338717ULL;
+}
+
+// ACCESSORS
+int Simulator::frame() const{
+  return d_frame;
+}
+
+int Simulator::numWords() const{
+  return d_words;
+}
+
+int Simulator::numLanes() const{
+  return d_words * LANES;
+}
+
+int Simulator::numGates() const{
+  return d_gateOut.size();
+}
+
+int Simulator::numLevels() const{
+  return d_numLevels;
+}
+
+const char* Simulator::kernelName() const{
+  switch(d_kernel){
+    case AVX512: return "AVX-512";
+    case AVX2:   return "AVX2";
+    default:     return "scalar";
+  }
+}
+
+SimWord Simulator::netValue(int cnfVar, int word) const{
+  if(cnfVar <= 0 || cnfVar >= d_netOfVar.size() || d_netOfVar[cnfVar] < 0)
+    return 0;
+  return d_value[d_netOfVar[cnfVar] * d_words + word];
+}
+
+SimWord Simulator::piValue(int pi, int word) const{
+  return d_value[d_piNet.at(pi) * d_words + word];
+}
+
+void Simulator::saveState(int lane, vector<char>* state_p) const{
+  state_p->resize(d_ppiNet.size());
+  for(int i = 0; i < d_ppiNet.size(); ++i){
+    SimWord w = d_value[d_ppoNet[i] * d_words + lane / LANES];
+    if(d_ppiInv[i]) w = ~w;
+    state_p->at(i) = (w >> (lane % LANES)) & 1;
+  }
+}
+
+bool Simulator::varWords(const CoverVariable* var_p, int msb, int lsb, int word, vector<SimWord>* bits_p) const{
+  map<const CoverVariable*, vector<int> >::const_iterator it = d_varNets.find(var_p);
+  bits_p->clear();
+  if(it == d_varNets.end())
+    return false;
+  for(int i = lsb; i <= msb; ++i){
+    if(it->second.at(i) < 0)
+      return false;
+    bits_p->push_back(d_value[it->second.at(i) * d_words + word]);
+  }
+  return true;
+}
+
+// Bit i of c, bits above 62 are 0
+static inline bool constBit(long long c, int i){
+  return (i < 63) ? ((c >> i) & 1) : false;
+}
+
+// c modulo 2^size, the CNF of a bin compares the selected bits to the low bits of its bounds
+static inline long long lowBits(long long c, int size){
+  return (size < 63) ? (c & ((1LL << size) - 1)) : c;
+}
+
+SimWord Simulator::lanesEqual(const vector<SimWord>& bits, long long c){
+  if(c < 0)
+    return 0;
+  c = lowBits(c, bits.size());
+  SimWord eq = ALL_LANES;
+  for(int i = 0; i < bits.size(); ++i)
+    eq &= constBit(c, i) ? bits[i] : ~bits[i];
+  return eq;
+}
+
+SimWord Simulator::lanesLessOrEqual(const vector<SimWord>& bits, long long c){
+  if(c < 0)
+    return 0;
+  c = lowBits(c, bits.size());
+  SimWord lt = 0, eq = ALL_LANES;
+  for(int i = bits.size() - 1; i >= 0; --i){
+    if(constBit(c, i)){
+      lt |= eq & ~bits[i];
+      eq &= bits[i];
+    }
+    else
+      eq &= ~bits[i];
+  }
+  return lt | eq;
+}
+
+SimWord Simulator::lanesGreaterOrEqual(const vector<SimWord>& bits, long long c){
+  if(c <= 0)
+    return ALL_LANES;
+  c = lowBits(c, bits.size());
+  SimWord gt = 0, eq = ALL_LANES;
+  for(int i = bits.size() - 1; i >= 0; --i){
+    if(constBit(c, i))
+      eq &= bits[i];
+    else{
+      gt |= eq & bits[i];
+      eq &= ~bits[i];
+    }
+  }
+  return gt | eq;
+}
+
+bool Simulator::kernelSupported(simKernel kernel){
+#ifdef SIM_X86
+  __builtin_cpu_init();
+  if(kernel == AVX512) return __builtin_cpu_supports("avx512f");
+  if(kernel == AVX2)   return __builtin_cpu_supports("avx2");
+#else
+  if(kernel == AVX512 || kernel == AVX2) return false;
+#endif
+  return kernel == SCALAR;
+}
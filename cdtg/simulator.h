@@ -0,0 +1,105 @@
+#ifndef INCLUDED_SIMULATOR
+#define INCLUDED_SIMULATOR
+
+#include <vector>
+#include <map>
+#include "circuit.h"
+
+using namespace std;
+
+class CoverGroup;
+class CoverVariable;
+
+typedef unsigned long long SimWord;   // One bit per lane
+
+// Levelized, word-parallel logic simulator of the circuit.
+// Every net holds numWords() SimWords, so 64 * numWords() independent stimulus
+// sequences are simulated at once. Frames follow the SAT unrolling of Trace:
+// frame 0 has all PI and PPI at 0 with reset active, later frames take random
+// PI, inactive reset and PPI(t) = PPO(t-1).
+// Gates are stored structure-of-arrays in level order, gates of one level are
+// grouped by type into blocks, and every block is evaluated by the widest
+// kernel the CPU supports (AVX-512: 8 words, AVX2: 4 words, scalar: 1 word).
+// Library cells are evaluated from their prime covers, once per output.
+class Simulator{
+    public:
+        enum {LANES = 64};                          // Lanes of one SimWord
+        enum simKernel {SCALAR, AVX2, AVX512, AUTO};
+
+    private:
+        // DATA
+        int                d_words;        // SimWords per net
+        simKernel          d_kernel;
+        vector<SimWord>    d_value;        // Net n holds d_value[n * d_words] ... d_value[n * d_words + d_words - 1]
+        vector<int>        d_netOfVar;     // d_netOfVar[v] gives the net of DIMACS variable v, -1 if none
+
+        // Combinational gates in level order, fanins in CSR form
+        vector<int>        d_gateOut;      // Output net
+        vector<int>        d_gateCover;    // CellLibrary output evaluated by gates of CELL blocks, -1 otherwise
+        vector<int>        d_faninBegin;   // Fanins of gate i are d_fanin[d_faninBegin[i]] ... d_fanin[d_faninBegin[i+1]-1]
+        vector<int>        d_fanin;
+        vector<int>        d_blockType;    // Gate::gateType of block b
+        vector<int>        d_blockBegin;   // Gates of block b are d_blockBegin[b] ... d_blockBegin[b+1]-1
+        int                d_numLevels;
+        const CellLibrary* d_library_p;
+
+        // Flip-flops, PPI(t) = PPO(t-1), inverted for QN ports
+        vector<int>        d_ppiNet;
+        vector<int>        d_ppoNet;
+        vector<char>       d_ppiInv;
+        vector<SimWord>    d_nextState;
+        vector<pair<int, vector<char> > > d_loadState;   // Lanes starting the next frame from a given state
+        vector<pair<int, vector<char> > > d_loadPI;      // Lanes taking given PI values in the next frame
+
+        vector<int>        d_piNet;
+        vector<int>        d_rstNet;
+        map<const CoverVariable*, vector<int> > d_varNets;   // Nets of the bits of a covergroup variable, -1 if none
+
+        bool               d_nR;           // Negative reset
+        int                d_frame;
+        int                d_bias;         // PI bias, < 0: mostly 0, 0: uniform, > 0: mostly 1
+        SimWord            d_rngState;
+
+    public:
+        // CREATORS
+        Simulator();
+
+        // MANIPULATORS
+        // Must be called while the covergroup variables still hold circuit DIMACS variables.
+        // The kernel is lowered to the widest one the CPU supports.
+        // False if the circuit has a combinational loop.
+        bool    build       (Circuit&, CoverGroup*, bool nR, simKernel kernel = AUTO);
+        void    seed        (SimWord);
+        void    setBias     (int bias);         // Each PI bit is 1 with probability 1/4 (bias < 0), 1/2 (0) or 3/4 (bias > 0)
+        void    reset       ();                 // Go to frame 0 in every lane
+        void    step        ();                 // Clock all lanes into the next frame with random PI
+        void    loadState   (int lane, const vector<char>& state);   // The lane leaves the next step() from state instead of its own
+        void    loadPI      (int lane, const vector<char>& piBits);  // The lane takes piBits[i] as Circuit::getPI(i) in the next step()
+
+        // ACCESSORS
+        int     frame       () const;
+        int     numWords    () const;
+        int     numLanes    () const;
+        int     numGates    () const;
+        int     numLevels   () const;
+        const char* kernelName () const;
+        SimWord netValue    (int cnfVar, int word) const; // Lanes of a DIMACS variable, 0 if it has no net
+        SimWord piValue     (int pi, int word) const;     // Lanes of Circuit::getPI(pi)
+        void    saveState   (int lane, vector<char>* state) const;   // Next state (PPI of the next frame) of a lane
+        // Lanes of bits [msb:lsb] of a covergroup variable in one word, bits->at(0) is bit lsb.
+        // False if some bit is not driven by the circuit (LOCAL variables).
+        bool    varWords    (const CoverVariable*, int msb, int lsb, int word, vector<SimWord>* bits) const;
+
+        // Lanes where the unsigned value of bits compares to c modulo 2^bits
+        static SimWord lanesEqual          (const vector<SimWord>& bits, long long c);
+        static SimWord lanesLessOrEqual    (const vector<SimWord>& bits, long long c);
+        static SimWord lanesGreaterOrEqual (const vector<SimWord>& bits, long long c);
+        static bool    kernelSupported     (simKernel);
+
+    private:
+        void    evaluate    ();
+        void    evaluateCells (int begin, int end);
+        SimWord random      ();
+};
+
+#endif
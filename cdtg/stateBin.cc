@@ -18,6 +18,7 @@ StateBin::StateBin(const string& name, const bool& isExcluded, const binType& ty
     d_msb        = msb;
     d_lsb        = lsb;
     d_maxValue   = maxValue;
+    d_decoder_p  = NULL;
 //  cout << "Start to build bin "  << d_name << endl;
 }
 
@@ -35,6 +36,7 @@ StateBin::StateBin(const int& value, const int& msb, const int& lsb, const int&
     d_msb         =  msb;
     d_lsb         =  lsb;
     d_maxValue    =  maxValue;
+    d_decoder_p   =  NULL;
     d_intervalSpec.insert(value);
 //  cout << "Start to build bin "  << d_name << endl;
 }
@@ -54,6 +56,7 @@ StateBin::StateBin(const int& lVal, const int& hVal, const int& msb, const int&
     d_msb          =  msb;
     d_lsb          =  lsb;
     d_maxValue     =  maxValue;
+    d_decoder_p    =  NULL;
     d_intervalSpec += interval<int>::closed(lVal, hVal);
 //  cout << "Start to build bin "  << d_name << endl;
 }
@@ -72,6 +75,7 @@ StateBin::StateBin(const string& name, const int& value, const int& msb, const i
     d_msb        =  msb;
     d_lsb        =  lsb;
     d_maxValue   =  maxValue;
+    d_decoder_p  =  NULL;
     d_intervalSpec.insert(value);
 //  cout << "Start to build bin "  << d_name << endl;
 }
@@ -88,6 +92,7 @@ StateBin::StateBin(const string& name, const int& lVal, const int& hVal, const s
     d_msb        =  msb;
     d_lsb        =  lsb;
     d_maxValue   =  maxValue;
+    d_decoder_p  =  NULL;
     
     set<int>::iterator it = multiValues.begin();
     for(int i = 0; i < lVal; ++i, ++it);
@@ -147,6 +152,10 @@ void StateBin::setCnfVar(const int cnfVar){
     d_cnfVar = cnfVar;
 }
 
+void StateBin::setDecoder(ValueDecoder* decoder_p){
+    d_decoder_p = decoder_p;
+}
+
 void StateBin::setMSB(int msb){
     d_msb = msb;
 }
@@ -154,9 +163,28 @@ void StateBin::setMSB(int msb){
 void StateBin::setLSB(int lsb){
     d_lsb = lsb;
 }
+
+void StateBin::addInterval(int lVal, int hVal){
+    d_intervalSpec += interval<int>::closed(lVal, hVal);
+}
     
-void StateBin::genCnf(int* cnfVar_p){
+void StateBin::genCnf(int* cnfVar_p, bool positiveOnly){
     d_cnfClause.clear(); // Generate a new set of clauses
+    d_positiveOnly = positiveOnly;
+    if(d_decoder_p != NULL){ // Shared decoder of the coverpoint
+        vector<int> nodeLits;
+        for(interval_set<int>::iterator it = d_intervalSpec.begin(); it != d_intervalSpec.end(); ++it)
+            if(!d_decoder_p->rangeLits(d_var_p->getCnfVarList(d_msb, d_lsb), first(*it), last(*it), cnfVar_p,
+                                       positiveOnly, &nodeLits, &d_cnfClause)){
+                if(!positiveOnly){ // Every value hits the bin
+                    d_cnfClause.push_back(d_cnfVar);
+                    d_cnfClause.push_back(0);
+                }
+                return;
+            }
+        genOrCnf(nodeLits, d_cnfVar);
+        return;
+    }
     interval_set<int>::iterator it = d_intervalSpec.begin();
     vector<int> intervalCnfVars;
     
@@ -196,6 +224,26 @@ const int& StateBin::getHitCount() const{
     return d_hitCount;
 }
 
+const bool& StateBin::isExcluded() const{
+    return d_isExcluded;
+}
+
+const BaseBin::binType& StateBin::getType() const{
+    return d_type;
+}
+
+const int& StateBin::getMSB() const{
+    return d_msb;
+}
+
+const int& StateBin::getLSB() const{
+    return d_lsb;
+}
+
+const interval_set<int>& StateBin::getIntervals() const{
+    return d_intervalSpec;
+}
+
 void StateBin::print() const{
     interval_set<int>::iterator it=d_intervalSpec.begin();
     cout << "{ ";  
@@ -228,6 +276,21 @@ const vector<int>& StateBin::getCNFClause() const{
     return d_cnfClause;
 }
 
+SimWord StateBin::simHit(const Simulator& sim, int word) const{
+    vector<SimWord> bits;
+    SimWord         hit = 0;
+    
+    if(!sim.varWords(d_var_p, d_msb, d_lsb, word, &bits))
+        return 0;
+    for(interval_set<int>::const_iterator it = d_intervalSpec.begin(); it != d_intervalSpec.end(); ++it){
+        if(first(*it) == last(*it))
+            hit |= Simulator::lanesEqual(bits, first(*it));
+        else
+            hit |= Simulator::lanesGreaterOrEqual(bits, first(*it)) & Simulator::lanesLessOrEqual(bits, last(*it));
+    }
+    return hit;
+}
+
 const bool StateBin::hasValue(int value) const{
     return contains(d_intervalSpec, value);
     // boost::icl function
@@ -404,7 +467,7 @@ void StateBin::SopToPos(vector<int>* clauseSet_p, int* cnfVar_p){
 
 void StateBin::genOrCnf(const vector<int>& cnfVarVec, int cnfVar, vector<int>* clauseSet_p){ // OR all vec vars and put in *clauseSet_p
     clauseSet_p->clear();
-    for(int i=0;i<cnfVarVec.size();++i){
+    for(int i=0;!d_positiveOnly && i<cnfVarVec.size();++i){
         clauseSet_p->push_back(-cnfVarVec[i]);
         clauseSet_p->push_back(cnfVar);
         clauseSet_p->push_back(0);
@@ -417,7 +480,7 @@ void StateBin::genOrCnf(const vector<int>& cnfVarVec, int cnfVar, vector<int>* c
 }
 
 void StateBin::genOrCnf(const vector<int>& cnfVarVec, int cnfVar){ // OR all vec vars and output in d_cnfClause
-    for(int i=0;i<cnfVarVec.size();++i){
+    for(int i=0;!d_positiveOnly && i<cnfVarVec.size();++i){
         d_cnfClause.push_back(-cnfVarVec[i]);
         d_cnfClause.push_back(cnfVar);
         d_cnfClause.push_back(0);
@@ -436,6 +499,8 @@ void StateBin::genAndCnf(const vector<int>& cnfVarVec, int cnfVar, vector<int>*
         clauseSet_p->push_back(-cnfVar);
         clauseSet_p->push_back(0);
     }
+    if(d_positiveOnly)
+        return;
     for(int i=0;i<cnfVarVec.size();++i)
         clauseSet_p->push_back(-cnfVarVec[i]);
     clauseSet_p->push_back(cnfVar);
@@ -448,6 +513,8 @@ void StateBin::genAndCnf(const vector<int>& cnfVarVec, int cnfVar){ // AND all v
         d_cnfClause.push_back(-cnfVar);
         d_cnfClause.push_back(0);
     }
+    if(d_positiveOnly)
+        return;
     for(int i=0;i<cnfVarVec.size();++i){
         d_cnfClause.push_back(-cnfVarVec[i]);
     }
@@ -458,11 +525,13 @@ void StateBin::genAndCnf(const vector<int>& cnfVarVec, int cnfVar){ // AND all v
 void StateBin::genAnd2Cnf(const int& in1,const int& in2, const int& cnfVar){// AND 2 vec vars
     d_cnfClause.push_back(in1);  d_cnfClause.push_back(-cnfVar);  d_cnfClause.push_back(0);
     d_cnfClause.push_back(in2);  d_cnfClause.push_back(-cnfVar);  d_cnfClause.push_back(0);
-    d_cnfClause.push_back(-in1); d_cnfClause.push_back(-in2); d_cnfClause.push_back(cnfVar); d_cnfClause.push_back(0);
+    if(!d_positiveOnly){
+        d_cnfClause.push_back(-in1); d_cnfClause.push_back(-in2); d_cnfClause.push_back(cnfVar); d_cnfClause.push_back(0);
+    }
 }
 
 void StateBin::int2bitvector(int i, vector<int>* bitString_p){
-    int r;
+    int r = 0;
     bitString_p->clear();
 
     //cout << " Value " << i << " = ";
@@ -6,6 +6,7 @@
 #include <set>
 #include <boost/icl/interval_set.hpp>
 #include "baseBin.h"
+#include "valueDecoder.h"
 
 using namespace std;
 using namespace boost::icl;
@@ -21,11 +22,13 @@ class StateBin : public BaseBin{
     // binType        d_type;
     // int            d_hitCount;
     // vector<int>    d_cnfClause;
+    // bool           d_positiveOnly;
     
     int               d_msb;
     int               d_lsb;
     int               d_maxValue;     // The maximum value could be specified
     interval_set<int> d_intervalSpec;
+    ValueDecoder*     d_decoder_p;    // Decoder shared by the bins of the coverpoint, NULL: bin-local comparators
     
     public:
         // CREATORS
@@ -54,16 +57,24 @@ class StateBin : public BaseBin{
         void    setCnfVar   (const int cnfVar);
         void    setMSB      (int msb);
         void    setLSB      (int lsb);
-        void    genCnf      (int* cnfVar);
+        void    setDecoder  (ValueDecoder*);
+        void    addInterval (int lVal, int hVal);
+        void    genCnf      (int* cnfVar, bool positiveOnly);
         void    plusCount   ();
         
         // ACCESSORS
         const string&      getName                  ()    const;
         const int&         getCnfVar                ()    const;
         const int&         getHitCount              ()    const;
+        const bool&        isExcluded               ()    const;
+        const binType&     getType                  ()    const;
+        const int&         getMSB                   ()    const;
+        const int&         getLSB                   ()    const;
+        const interval_set<int>& getIntervals       ()    const;
         void               print                    ()    const;
         void               printClause              ()    const;
         const vector<int>& getCNFClause             ()    const;
+        SimWord            simHit                   (const Simulator&, int word) const;
                       
         const bool         hasValue                 (int) const;
         const bool         hasValueLessOrEqualTo    (int) const;
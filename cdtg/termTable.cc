@@ -0,0 +1,58 @@
+#include "termTable.h"
+#include <algorithm>
+
+// MANIPULATORS
+void TermTable::reset(){
+    d_and.clear();
+    d_or.clear();
+}
+
+int TermTable::andLit(const vector<int>& lits, int* cnfVar_p, bool positiveOnly, vector<int>* clauses){
+    return term(&d_and, true, lits, cnfVar_p, positiveOnly, clauses);
+}
+
+int TermTable::orLit(const vector<int>& lits, int* cnfVar_p, bool positiveOnly, vector<int>* clauses){
+    return term(&d_or, false, lits, cnfVar_p, positiveOnly, clauses);
+}
+
+int TermTable::term(map<vector<int>, int>* table, bool isAnd, const vector<int>& lits,
+                    int* cnfVar_p, bool positiveOnly, vector<int>* clauses){
+    vector<int> key(lits);
+    sort(key.begin(), key.end());
+    key.erase(unique(key.begin(), key.end()), key.end());
+    if(key.size() == 1)
+        return key.at(0);
+
+    map<vector<int>, int>::iterator it = table->find(key);
+    if(it != table->end())
+        return it->second;
+
+    const int var = ++(*cnfVar_p);
+    // var -> inputs
+    if(isAnd){
+        for(int i = 0; i < key.size(); ++i){
+            clauses->push_back(-var); clauses->push_back(key[i]); clauses->push_back(0);
+        }
+    }
+    else{
+        clauses->push_back(-var);
+        for(int i = 0; i < key.size(); ++i)
+            clauses->push_back(key[i]);
+        clauses->push_back(0);
+    }
+    // inputs -> var
+    if(!positiveOnly){
+        if(isAnd){
+            for(int i = 0; i < key.size(); ++i)
+                clauses->push_back(-key[i]);
+            clauses->push_back(var); clauses->push_back(0);
+        }
+        else{
+            for(int i = 0; i < key.size(); ++i){
+                clauses->push_back(-key[i]); clauses->push_back(var); clauses->push_back(0);
+            }
+        }
+    }
+    (*table)[key] = var;
+    return var;
+}
@@ -0,0 +1,34 @@
+#ifndef INCLUDED_TERM_TABLE
+#define INCLUDED_TERM_TABLE
+
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// Hash-consing table of the AND and OR terms built by cross bins.
+// A term is keyed by the sorted set of its input literals, so an identical
+// product or OR group is defined once and its literal is shared by every bin
+// and every cross that asks for it. Inputs are DIMACS literals of one frame:
+// the table starts over with the bin CNF of every frame (reset()).
+class TermTable{
+    private:
+        // DATA
+        map<vector<int>, int> d_and;      // Sorted inputs -> term variable
+        map<vector<int>, int> d_or;
+
+    public:
+        // MANIPULATORS
+        void reset      ();
+        // Literal of the AND (OR) of lits, a single input is returned as it is.
+        // The definition of a new term is appended to clauses, positiveOnly
+        // leaves out the clauses that imply the term from its inputs.
+        int  andLit     (const vector<int>& lits, int* cnfVar_p, bool positiveOnly, vector<int>* clauses);
+        int  orLit      (const vector<int>& lits, int* cnfVar_p, bool positiveOnly, vector<int>* clauses);
+
+    private:
+        int  term       (map<vector<int>, int>* table, bool isAnd, const vector<int>& lits,
+                         int* cnfVar_p, bool positiveOnly, vector<int>* clauses);
+};
+
+#endif
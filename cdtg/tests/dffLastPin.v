@@ -0,0 +1,17 @@
+module dffLastPin ( clk, rst, a, b, y );
+  input clk;
+  input rst;
+  input a;
+  input b;
+  output y;
+  wire q;
+  wire qn;
+  wire p;
+  wire d;
+  wire n1;
+  AND2X1 g1 ( .A(a), .B(b), .Y(d) );
+  DFFRX1 r1 ( .D(d), .CK(clk), .Q(q), .QN(qn), .RN(rst) );
+  DFFRX1 r2 ( .D(a), .CK(clk), .Q(p), .RN(rst) );
+  AND2X1 g2 ( .A(q), .B(qn), .Y(n1) );
+  AND2X1 g3 ( .A(n1), .B(p), .Y(y) );
+endmodule
@@ -0,0 +1,11 @@
+module partialSelect ( clk, rst, a, y );
+  input clk;
+  input rst;
+  input [3:0] a;
+  output y;
+  wire q;
+  wire n1;
+  AND2X1 g1 ( .A(a[0]), .B(a[1]), .Y(n1) );
+  DFFX1 r1 ( .D(n1), .CK(clk), .Q(q) );
+  AND2X1 g2 ( .A(q), .B(a[2]), .Y(y) );
+endmodule
@@ -0,0 +1,35 @@
+#!/bin/sh
+# Regression runs of cdtg, "make test" runs them on the standard build.
+# Every case is NAME.v and NAME.cov in this directory, the options of the run
+# and a line the output must contain.
+cd "$(dirname "$0")"
+CDTG=${CDTG:-../cdtg}
+failed=0
+
+check(){
+  name=$1
+  expect=$2
+  shift 2
+  if "$CDTG" "$@" $name.v $name.cov 2>&1 | grep -q "$expect"; then
+    echo "PASS: $name $*"
+  else
+    echo "FAIL: $name $*"
+    failed=1
+  fi
+}
+
+# Auto bins of a[1:0] go up to the maximum value of a, values above 3 are
+# matched on the two selected bits, so every bin can be hit
+check partialSelect "All bins are covered" -d=3
+check partialSelect "All bins are covered" -d=3 -pg
+check partialSelect "All bins are covered" -d=3 -aig
+check partialSelect "16 hits, 0 bins left" -d=3 -sim=640
+
+# Flip-flops whose last pin is .RN drive only .Q and .QN, the reset pin is an input
+check dffLastPin "All bins are covered" -d=3
+check dffLastPin "All bins are covered" -d=3 -aig
+check dffLastPin "All bins are covered" -d=3 -sim=640
+
+# Test patterns written by the runs
+rm -f patterns.p
+exit $failed
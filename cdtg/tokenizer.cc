@@ -0,0 +1,299 @@
+#include "tokenizer.h"
+#include <iostream>
+#include <algorithm>
+#include <string.h>
+#include <limits.h>
+#include <zlib.h>
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static bool isWordChar(char c){
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '$' || c == '\'';
+}
+
+static bool isBlank(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+// Token
+bool Tokenizer::Token::is(const char* s) const{
+    return strncmp(str, s, length) == 0 && s[length] == '\0';
+}
+
+bool Tokenizer::Token::contains(const char* s) const{
+    int n = strlen(s);
+    for(int i = 0; i + n <= length; ++i)
+        if(strncmp(str + i, s, n) == 0)
+            return true;
+    return false;
+}
+
+int Tokenizer::Token::toInt() const{
+    int  v   = 0;
+    bool neg = (length > 0 && str[0] == '-');
+    for(int i = neg ? 1 : 0; i < length && str[i] >= '0' && str[i] <= '9'; ++i)
+        v = 10 * v + (str[i] - '0');
+    return neg ? -v : v;
+}
+
+// CREATORS
+Tokenizer::Tokenizer(){
+    d_begin   = NULL;
+    d_end     = NULL;
+    d_pos     = NULL;
+    d_map     = NULL;
+    d_mapSize = 0;
+    d_openComment = false;
+}
+
+Tokenizer::~Tokenizer(){
+    close();
+}
+
+// MANIPULATORS
+bool Tokenizer::open(const char* fileName){
+    struct stat st;
+    int fd;
+
+    close();
+    if((fd = ::open(fileName, O_RDONLY)) < 0)
+        return false;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(map != MAP_FAILED){
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            d_map     = map;
+            d_mapSize = st.st_size;
+        }
+    }
+    if(d_map == NULL){
+        char    buf[65536];
+        ssize_t n;
+        while((n = read(fd, buf, sizeof(buf))) > 0)
+            d_buffer.insert(d_buffer.end(), buf, buf + n);
+    }
+    ::close(fd);
+
+    // Compressed input is detected by its magic number and expanded in memory
+    const unsigned char* raw  = (d_map != NULL) ? (const unsigned char*)d_map : (const unsigned char*)(d_buffer.empty() ? NULL : &d_buffer[0]);
+    size_t               size = (d_map != NULL) ? d_mapSize : d_buffer.size();
+    if(size >= 2 && raw[0] == 0x1f && raw[1] == 0x8b){
+        if(!decompress(raw, size, GZIP)){
+            cout << "Corrupted gzip input: " << fileName << endl;
+            close();
+            return false;
+        }
+    }
+    else if(size >= 4 && raw[0] == 0x28 && raw[1] == 0xb5 && raw[2] == 0x2f && raw[3] == 0xfd){
+        if(!decompress(raw, size, ZSTD)){
+#ifdef USE_ZSTD
+            cout << "Corrupted zstd input: " << fileName << endl;
+#else
+            cout << "zstd input needs a build with USE_ZSTD: " << fileName << endl;
+#endif
+            close();
+            return false;
+        }
+    }
+
+    if(d_map != NULL){
+        d_begin = (const char*)d_map;
+        d_end   = d_begin + d_mapSize;
+    }
+    else{
+        d_begin = d_buffer.empty() ? NULL : &d_buffer[0];
+        d_end   = d_begin + d_buffer.size();
+    }
+    d_pos = d_begin;
+    return true;
+}
+
+void Tokenizer::close(){
+    if(d_map != NULL)
+        munmap(d_map, d_mapSize);
+    d_map     = NULL;
+    d_mapSize = 0;
+    d_buffer.clear();
+    d_begin = d_end = d_pos = NULL;
+    d_openComment = false;
+}
+
+void Tokenizer::attach(const char* begin, const char* end){
+    close();
+    d_begin = begin;
+    d_end   = end;
+    d_pos   = begin;
+}
+
+bool Tokenizer::next(Token* token_p){
+    const char* p;
+
+    skipBlanks();
+    if(d_pos == d_end)
+        return false;
+    p = d_pos;
+    if(isWordChar(*p)){
+        while(p != d_end && isWordChar(*p))
+            ++p;
+    }
+    else if(*p == '\\'){
+        while(p != d_end && !isBlank(*p))
+            ++p;
+    }
+    else
+        ++p;
+    token_p->str    = d_pos;
+    token_p->length = p - d_pos;
+    d_pos = p;
+    return true;
+}
+
+bool Tokenizer::peek(Token* token_p){
+    const char* pos = d_pos;
+    bool        ok  = next(token_p);
+    d_pos = pos;
+    return ok;
+}
+
+bool Tokenizer::getLine(string* str_p){
+    str_p->clear();
+    if(d_pos == d_end)
+        return false;
+    const char* eol = (const char*)memchr(d_pos, '\n', d_end - d_pos);
+    if(eol == NULL)
+        eol = d_end;
+    for(const char* p = d_pos; p != eol; ++p)
+        if(!isBlank(*p))
+            str_p->push_back(*p);
+    d_pos = (eol == d_end) ? d_end : eol + 1;
+    return true;
+}
+
+bool Tokenizer::skipPast(char c){
+    Token token;
+    while(next(&token))
+        if(token.is(c))
+            return true;
+    return false;
+}
+
+void Tokenizer::setPosition(const char* pos){
+    d_pos = pos;
+}
+
+// ACCESSORS
+const char* Tokenizer::position() const{
+    return d_pos;
+}
+
+const char* Tokenizer::begin() const{
+    return d_begin;
+}
+
+const char* Tokenizer::end() const{
+    return d_end;
+}
+
+bool Tokenizer::openComment() const{
+    return d_openComment;
+}
+
+// UTILITIES
+// Inflates the raw file into d_buffer step by step and releases the raw file,
+// false on corrupted input
+bool Tokenizer::decompress(const unsigned char* raw, size_t size, compression type){
+    enum {STEP = 1 << 20};
+    vector<char> out;
+    size_t       outSize = 0;
+    bool         ok      = false;
+
+    out.resize(max((size_t)STEP, 4 * size));
+    if(type == GZIP){
+        z_stream zs;
+        int      ret    = Z_OK;
+        size_t   inLeft = size;   // Not yet handed to zlib, avail_in and avail_out are 32 bits
+        memset(&zs, 0, sizeof(zs));
+        if(inflateInit2(&zs, 15 + 32) != Z_OK)  // gzip or zlib header
+            return false;
+        zs.next_in = (Bytef*)raw;
+        while(ret == Z_OK || ret == Z_BUF_ERROR){
+            if(zs.avail_in == 0 && inLeft > 0){
+                zs.avail_in = min(inLeft, (size_t)UINT_MAX);
+                inLeft     -= zs.avail_in;
+            }
+            if(outSize == out.size())
+                out.resize(2 * out.size());
+            uInt outStep = min(out.size() - outSize, (size_t)UINT_MAX);
+            zs.next_out  = (Bytef*)&out[outSize];
+            zs.avail_out = outStep;
+            ret = inflate(&zs, Z_NO_FLUSH);
+            outSize += outStep - zs.avail_out;
+            // Concatenated members (gzip -c a b, pigz)
+            if(ret == Z_STREAM_END && (zs.avail_in > 0 || inLeft > 0) && inflateReset(&zs) == Z_OK)
+                ret = Z_OK;
+            if(ret == Z_BUF_ERROR && zs.avail_in == 0 && inLeft == 0)
+                break;
+        }
+        ok = (ret == Z_STREAM_END);
+        inflateEnd(&zs);
+    }
+#ifdef USE_ZSTD
+    else if(type == ZSTD){
+        ZSTD_DStream*  zs  = ZSTD_createDStream();
+        ZSTD_inBuffer  in  = {raw, size, 0};
+        size_t         ret = ZSTD_initDStream(zs);
+        // ret == 0 once the last frame is decoded and flushed
+        while(!ZSTD_isError(ret) && (in.pos < in.size || ret != 0)){
+            if(outSize == out.size())
+                out.resize(2 * out.size());
+            ZSTD_outBuffer outBuf = {&out[outSize], out.size() - outSize, 0};
+            ret = ZSTD_decompressStream(zs, &outBuf, &in);
+            outSize += outBuf.pos;
+            if(ret != 0 && in.pos == in.size && outBuf.pos < outBuf.size)   // Truncated
+                break;
+        }
+        ok = (!ZSTD_isError(ret) && ret == 0);
+        ZSTD_freeDStream(zs);
+    }
+#endif
+    if(!ok)
+        return false;
+
+    out.resize(outSize);
+    if(d_map != NULL)
+        munmap(d_map, d_mapSize);
+    d_map     = NULL;
+    d_mapSize = 0;
+    d_buffer.swap(out);
+    return true;
+}
+
+void Tokenizer::skipBlanks(){
+    while(d_pos != d_end){
+        if(isBlank(*d_pos))
+            ++d_pos;
+        else if(*d_pos == '/' && d_pos + 1 != d_end && d_pos[1] == '/'){
+            const char* eol = (const char*)memchr(d_pos, '\n', d_end - d_pos);
+            d_pos = (eol == NULL) ? d_end : eol;
+        }
+        else if(*d_pos == '/' && d_pos + 1 != d_end && d_pos[1] == '*'){
+            for(d_pos += 2; d_pos != d_end && !(*d_pos == '*' && d_pos + 1 != d_end && d_pos[1] == '/'); ++d_pos);
+            if(d_pos == d_end)
+                d_openComment = true;
+            else
+                d_pos += 2;
+        }
+        else if(*d_pos == '`'){
+            const char* eol = (const char*)memchr(d_pos, '\n', d_end - d_pos);
+            d_pos = (eol == NULL) ? d_end : eol;
+        }
+        else
+            return;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef INCLUDED_TOKENIZER
+#define INCLUDED_TOKENIZER
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+using namespace std;
+
+// Lexer over a memory-mapped input file.
+// Tokens are views into the mapped bytes, nothing is copied per token or per line,
+// and they stay valid until the file is closed.
+// A token is a word (letters, digits, '_', '$' and '\'', so 1'b0 is one token),
+// an escaped identifier (from '\\' up to the next white space) or a single
+// punctuation character. White space, // and /* */ comments and `directive
+// lines are skipped.
+// Files that cannot be mapped (pipes) are read into memory instead.
+// gzip input (and zstd input when built with USE_ZSTD) is recognized by its magic
+// number and decompressed in memory, so compressed netlists need no scratch copy.
+// Several Tokenizers can attach to disjoint ranges of one file and run in parallel.
+class Tokenizer{
+    public:
+        struct Token{
+          const char* str;
+          int         length;
+
+          bool is       (char c) const { return length == 1 && *str == c; }
+          bool is       (const char*) const;
+          bool contains (const char*) const;
+          int  toInt    () const;
+          string toString () const { return string(str, length); }
+        };
+
+    private:
+        enum compression {GZIP, ZSTD};
+
+        // DATA
+        const char*   d_begin;
+        const char*   d_end;
+        const char*   d_pos;
+        void*         d_map;        // Mapped file, NULL if read into d_buffer
+        size_t        d_mapSize;
+        vector<char>  d_buffer;
+        bool          d_openComment; // A block comment runs past the end
+
+        // NOT IMPLEMENTED
+        Tokenizer(const Tokenizer&);
+        Tokenizer& operator=(const Tokenizer&);
+
+    public:
+        // CREATORS
+        Tokenizer();
+        ~Tokenizer();
+
+        // MANIPULATORS
+        bool open        (const char* fileName);   // False if the file cannot be opened
+        void close       ();
+        void attach      (const char* begin, const char* end);   // Tokenize memory owned by another Tokenizer
+        bool next        (Token*);                 // False at the end of the file
+        bool peek        (Token*);                 // Next token without consuming it
+        bool getLine     (string*);                // Rest of the current line without blanks, false at the end of the file
+        bool skipPast    (char c);                 // Consume tokens up to and including c, false if there is no c
+        void setPosition (const char* pos);
+
+        // ACCESSORS
+        const char* position    () const;
+        const char* begin       () const;
+        const char* end         () const;
+        bool        openComment () const;
+
+    private:
+        bool decompress  (const unsigned char* raw, size_t size, compression);
+        void skipBlanks  ();
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "valueDecoder.h"
+
+// MANIPULATORS
+void ValueDecoder::reset(){
+    d_bits.clear();
+    d_node.clear();
+}
+
+bool ValueDecoder::rangeLits(const vector<int>& bits, int lower, int upper, int* cnfVar_p, bool positiveOnly,
+                             vector<int>* lits, vector<int>* clauses){
+    const int n = bits.size();
+    const long long maxValue = (1LL << n) - 1;
+
+    if(bits != d_bits){
+        reset();
+        d_bits = bits;
+    }
+    // Bounds past the selected bits compare on their low bits, as genRangeCnf() does,
+    // an empty range then gives no literal
+    if(lower < 0) lower = 0;
+    lower &= maxValue;
+    upper &= maxValue;
+
+    // Largest aligned blocks from lower up, a block of 2^j values is a node of length n-j
+    for(long long l = lower; l <= upper; ){
+        int j = 0;
+        while(j < n && (l & (1LL << j)) == 0 && l + (1LL << (j + 1)) - 1 <= upper)
+            ++j;
+        if(j == n)
+            return false;
+        lits->push_back( node(n - j, (int)(l >> j), cnfVar_p, positiveOnly, clauses) );
+        l += 1LL << j;
+    }
+    return true;
+}
+
+int ValueDecoder::node(int k, int prefix, int* cnfVar_p, bool positiveOnly, vector<int>* clauses){
+    const int bit = d_bits.at(d_bits.size() - k);
+    const int lit = (prefix & 1) ? bit : -bit;
+    if(k == 1)
+        return lit;
+
+    map<pair<int, int>, int>::iterator it = d_node.find(make_pair(k, prefix));
+    if(it != d_node.end())
+        return it->second;
+
+    const int parent = node(k - 1, prefix >> 1, cnfVar_p, positiveOnly, clauses);
+    const int var    = ++(*cnfVar_p);
+    clauses->push_back(-var); clauses->push_back(parent); clauses->push_back(0);
+    clauses->push_back(-var); clauses->push_back(lit);    clauses->push_back(0);
+    if(!positiveOnly){
+        clauses->push_back(var); clauses->push_back(-parent); clauses->push_back(-lit); clauses->push_back(0);
+    }
+    d_node[make_pair(k, prefix)] = var;
+    return var;
+}
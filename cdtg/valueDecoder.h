@@ -0,0 +1,37 @@
+#ifndef INCLUDED_VALUE_DECODER
+#define INCLUDED_VALUE_DECODER
+
+#include <vector>
+#include <map>
+
+using namespace std;
+
+// Shared decoder of the value sampled by a coverpoint, a binary trie over its bits.
+// Node (k, p) is a DIMACS literal that holds iff the k most significant bits of
+// the value equal p, and is defined as node (k-1, p>>1) AND one bit, so every node
+// costs one variable and at most three clauses. A range [lower, upper] splits
+// into at most 2*bits aligned blocks, each one node, and the bins of a coverpoint
+// share the nodes of their common prefixes.
+// Nodes live as long as the variables of the sampled bits: the decoder starts over
+// when the bits change (next frame) or on reset() (next solver).
+class ValueDecoder{
+    private:
+        // DATA
+        vector<int>           d_bits;     // DIMACS variables of the sampled bits, LSB first
+        map<pair<int, int>, int> d_node;  // (k, p) -> literal
+
+    public:
+        // MANIPULATORS
+        void reset      ();
+        // Appends to lits the node literals whose OR holds iff lower <= value <= upper, and to
+        // clauses the definitions of new nodes, positiveOnly leaves out node -> (parent AND bit).
+        // The bounds are taken modulo 2^bits like genEqualCnf()/genRangeCnf() in StateBin.
+        // False if the range holds every value, lits is left unchanged then.
+        bool rangeLits  (const vector<int>& bits, int lower, int upper, int* cnfVar_p, bool positiveOnly,
+                         vector<int>* lits, vector<int>* clauses);
+
+    private:
+        int  node       (int k, int prefix, int* cnfVar_p, bool positiveOnly, vector<int>* clauses);
+};
+
+#endif
@@ -41,6 +41,7 @@ static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby r
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption    opt_target_first      (_cat, "target-first", "Decide on the targets before the activity order (scans the targets at every decision)", false);
 
 
 //=================================================================================================
@@ -61,6 +62,7 @@ Solver::Solver():
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
   , garbage_frac     (opt_garbage_frac)
+  , target_first     (opt_target_first)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
 
@@ -88,6 +90,8 @@ Solver::Solver():
   , order_heap         (VarOrderLt(activity))
   , progress_estimate  (0)
   , remove_satisfied   (true)
+  , target_act         (var_Undef)
+  , target_clause      (CRef_Undef)
 
     // Resource constraints:
     //
@@ -119,6 +123,30 @@ Var Solver::newVar(bool sign, bool dvar){
     return v;
 }
 
+// Grows every per-variable structure once instead of once per variable.
+Var Solver::newVars(int n, bool sign, bool dvar){
+    int v = nVars();
+    if (n <= 0) return v;
+
+    watches  .init(mkLit(v+n-1, true));
+    assigns  .growTo(v+n, l_Undef);
+    vardata  .growTo(v+n, mkVarData(CRef_Undef, 0));
+    if (rnd_init_act){
+        activity.capacity(v+n);
+        for (int i = 0; i < n; i++)
+            activity.push(drand(random_seed) * 0.00001);
+    }else
+        activity.growTo(v+n, 0);
+    seen     .growTo(v+n, 0);
+    polarity .growTo(v+n, sign);
+    decision .growTo(v+n, 0);
+    trail    .capacity(v+n);
+    for (int i = v; i < v+n; i++)
+        setDecisionVar(i, dvar);
+    return v;
+}
+
+
 bool Solver::addClause_(vec<Lit>& ps){
     assert(decisionLevel() == 0);
     if(!ok) return false;
@@ -154,6 +182,56 @@ bool Solver::addClause_(vec<Lit>& ps){
     return true;
 }
 
+// Same simplification as 'addClause_()', but all clauses are allocated first and then attached
+// in one pass. Unit clauses are only enqueued, and propagated once at the end.
+bool Solver::addClauses(const vec<Lit>& ps, const vec<int>& begin, Var shift){
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+
+    int n = begin.size() - 1;
+    if (n <= 0) return true;
+
+    ca.reserve(n, begin[n] - begin[0]);
+    clauses.capacity(clauses.size() + n);
+
+    int first = clauses.size();
+    vec<Lit> c;
+    for (int k = 0; k < n; k++){
+        c.clear();
+        for (int i = begin[k]; i < begin[k+1]; i++)
+            c.push(mkLit(var(ps[i]) + shift, sign(ps[i])));
+
+        // Check if clause is satisfied and remove false/duplicate literals:
+        sort(c);
+        Lit p;
+        int i, j;
+        bool satisfied = false;
+        for (i = j = 0, p = lit_Undef; i < c.size(); i++)
+            if (value(c[i]) == l_True || c[i] == ~p){
+                satisfied = true;
+                break;
+            }else if (value(c[i]) != l_False && c[i] != p)
+                c[j++] = p = c[i];
+        if (satisfied) continue;
+        c.shrink(i - j);
+
+        if (c.size() == 0)
+            ok = false;
+        else if (c.size() == 1)
+            uncheckedEnqueue(c[0]);
+        else
+            clauses.push(ca.alloc(c, false));
+
+        if (!ok) break;
+    }
+
+    for (int k = first; k < clauses.size(); k++)
+        attachClause(clauses[k]);
+
+    return ok && (ok = (propagate() == CRef_Undef));
+}
+
+
 void Solver::attachClause(CRef cr){
   const Clause& c = ca[cr];
   assert(c.size() > 1);
@@ -215,6 +293,106 @@ void Solver::cancelUntil(int level){
 }
 
 
+// Subset test on sorted literal vectors.
+static bool isSubset(const vec<Lit>& sub, const vec<Lit>& set){
+    int j = 0;
+    for(int i = 0; i < sub.size(); i++){
+        while(j < set.size() && set[j] < sub[i]) j++;
+        if(j == set.size() || set[j] != sub[i]) return false;
+    }
+    return true;
+}
+
+// The target set is the clause '~target_act | targets', with 'target_act' assumed by every call to
+// 'solve_()'. Learnt clauses depending on it contain '~target_act', so shrinking the set keeps them
+// (the new clause implies the old one) and any other change removes them and reuses 'target_act'.
+// 'target_act' is retired only once it is false at level 0.
+void Solver::setTargets(const vec<Lit>& ts){
+    assert(decisionLevel() == 0);
+    if(!ok) return;
+
+    vec<Lit> sorted;
+    ts.copyTo(sorted);
+    sort(sorted);
+    int i, j;
+    for(i = j = 0; i < sorted.size(); i++)
+        if(j == 0 || sorted[i] != sorted[j-1])
+            sorted[j++] = sorted[i];
+    sorted.shrink(i - j);
+
+    if(target_act != var_Undef && isSubset(sorted, targets)){
+        if(target_clause != CRef_Undef)
+            removeClause(target_clause);
+        target_clause = CRef_Undef;
+    }else if(target_act != var_Undef && value(target_act) == l_Undef)
+        purgeTargets();
+    else{
+        clearTargets();
+        if(!ok) return;
+        target_act = newVar(true, false);
+    }
+    sorted.moveTo(targets);
+
+    add_tmp.clear();
+    add_tmp.push(~mkLit(target_act));
+    for(i = 0; i < targets.size(); i++)
+        if(value(targets[i]) == l_True)
+            return;
+        else if(value(targets[i]) != l_False)
+            add_tmp.push(targets[i]);
+
+    if(add_tmp.size() == 1){    // Every target is false, no model left under the target set
+        if(value(target_act) == l_Undef){
+            uncheckedEnqueue(~mkLit(target_act));
+            ok = (propagate() == CRef_Undef);
+        }
+    }else{
+        target_clause = ca.alloc(add_tmp, false);
+        attachClause(target_clause);
+    }
+}
+
+void Solver::clearTargets(){
+    assert(decisionLevel() == 0);
+    if(target_act == var_Undef) return;
+
+    if(target_clause != CRef_Undef)
+        removeClause(target_clause);
+    target_clause = CRef_Undef;
+    targets.clear();
+
+    // Learnt clauses over '~target_act' become satisfied and are removed by 'simplify()':
+    if(value(target_act) == l_Undef){
+        uncheckedEnqueue(~mkLit(target_act));
+        ok = (propagate() == CRef_Undef);
+    }
+    target_act = var_Undef;
+}
+
+// Remove the target clause and every clause learnt from it, 'target_act' stays unassigned for the
+// next target set. No such clause is a reason at level 0 while 'target_act' is unassigned.
+void Solver::purgeTargets(){
+    if(target_clause != CRef_Undef)
+        removeClause(target_clause);
+    target_clause = CRef_Undef;
+    targets.clear();
+
+    Lit off = ~mkLit(target_act);
+    int i, j;
+    for(i = j = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        int k = 0;
+        while(k < c.size() && c[k] != off) k++;
+        if(k < c.size())
+            removeClause(learnts[i]);
+        else
+            learnts[j++] = learnts[i];
+    }
+    learnts.shrink(i - j);
+    checkGarbage();
+}
+
+
 //=================================================================================================
 // Major methods:
 
@@ -222,6 +400,22 @@ void Solver::cancelUntil(int level){
 Lit Solver::pickBranchLit(){
     Var next = var_Undef;
 
+    // Target decision, the most active unassigned target while none is true:
+    if(target_first && target_clause != CRef_Undef){
+        Lit best = lit_Undef;
+        for(int i = 0; i < targets.size(); i++){
+            Lit t = targets[i];
+            if(value(t) == l_True){
+                best = lit_Undef;
+                break;
+            }
+            if(value(t) == l_Undef && (best == lit_Undef || activity[var(t)] > activity[var(best)]))
+                best = t;
+        }
+        if(best != lit_Undef)
+            return best;
+    }
+
     // Random decision:
     if(drand(random_seed) < random_var_freq && !order_heap.empty()){
         next = order_heap[irand(random_seed,order_heap.size())];
@@ -755,6 +949,14 @@ lbool Solver::solve_(){
     conflict.clear();
     if(!ok) return l_False;
 
+    // The target set is active through its assumption, placed before the user assumptions:
+    if(target_act != var_Undef){
+        assumptions.push(lit_Undef);
+        for(int i = assumptions.size() - 1; i > 0; i--)
+            assumptions[i] = assumptions[i-1];
+        assumptions[0] = mkLit(target_act);
+    }
+
     solves++;
 
     max_learnts             = nClauses() * learntsize_factor;
@@ -790,6 +992,17 @@ lbool Solver::solve_(){
     else if(status == l_False && conflict.size() == 0)
         ok = false;
 
+    if(target_act != var_Undef){
+        for(int i = 0; i < assumptions.size() - 1; i++)
+            assumptions[i] = assumptions[i+1];
+        assumptions.pop();
+        int i, j;
+        for(i = j = 0; i < conflict.size(); i++)
+            if(var(conflict[i]) != target_act)
+                conflict[j++] = conflict[i];
+        conflict.shrink(i - j);
+    }
+
     cancelUntil(0);
     return status;
 }
@@ -900,6 +1113,11 @@ void Solver::relocAll(ClauseAllocator& to){
     //
     for(int i = 0; i < clauses.size(); i++)
         ca.reloc(clauses[i], to);
+
+    // Target clause:
+    //
+    if(target_clause != CRef_Undef)
+        ca.reloc(target_clause, to);
 }
 
 void Solver::garbageCollect(){
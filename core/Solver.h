@@ -41,6 +41,7 @@ class Solver{
 
         // Problem specification:
         Var     newVar    (bool polarity = true, bool dvar = true); // Add a new variable with parameters specifying variable mode.
+        Var     newVars   (int n, bool polarity = true, bool dvar = true); // Add 'n' new variables at once, returns the first one.
         bool    addClause (const vec<Lit>& ps);                     // Add a clause to the solver. 
         bool    addEmptyClause();                                   // Add the empty clause, making the solver contradictory.
         bool    addClause (Lit p);                                  // Add a unit clause to the solver. 
@@ -48,6 +49,13 @@ class Solver{
         bool    addClause (Lit p, Lit q, Lit r);                    // Add a ternary clause to the solver. 
         bool    addClause_(vec<Lit>& ps);                           // Add a clause to the solver without making superflous internal copy. Will
                                                                     // change the passed vector 'ps'.
+        bool    addClauses(const vec<Lit>& ps, const vec<int>& begin, Var shift = 0);
+                                                                    // Add a batch of clauses, clause i is 'ps[begin[i]] ... ps[begin[i+1]-1]'
+                                                                    // with every variable shifted by 'shift'.
+        // Targets: every model must make at least one target literal true.
+        void    setTargets   (const vec<Lit>& ts);      // Replace the target set. Clauses learnt under the old set are kept if 'ts' is a subset of it.
+        void    clearTargets ();                        // Drop the target set and every clause learnt from it.
+
         // Solving:
         bool    simplify     ();                        // Removes already satisfied clauses.
         bool    solve        (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions.
@@ -112,6 +120,7 @@ class Solver{
         bool      rnd_pol;            // Use random polarities for branching heuristics.
         bool      rnd_init_act;       // Initialize variable activities with a small random value.
         double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
+        bool      target_first;       // Decide on an unassigned target while no target is true.
 
         int       restart_first;      // The initial restart limit.                                                                (default 100)
         double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
@@ -173,6 +182,10 @@ class Solver{
         Heap<VarOrderLt>    order_heap;        // A priority queue of variables ordered with respect to the variable activity.
         double              progress_estimate; // Set by 'search()'.
         bool                remove_satisfied;  // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
+        vec<Lit>            targets;           // Current target set, sorted.
+        Var                 target_act;        // Assumed true by 'solve_()' while a target set is active. Clauses learnt from the
+                                               // target clause contain '~target_act' and are removed with it. 'var_Undef' if no target set.
+        CRef                target_clause;     // The clause '~target_act | targets', 'CRef_Undef' if some target is true at level 0.
 
         ClauseAllocator     ca;
 
@@ -220,6 +233,7 @@ class Solver{
         void     attachClause     (CRef cr);                      // Attach a clause to watcher lists.
         void     detachClause     (CRef cr, bool strict = false); // Detach a clause to watcher lists.
         void     removeClause     (CRef cr);                      // Detach and free a clause.
+        void     purgeTargets     ();                             // Remove the target clause and every clause learnt from it.
         bool     locked           (const Clause& c) const;        // Returns TRUE if a clause is a reason for some implication in the current state.
         bool     satisfied        (const Clause& c) const;        // Returns TRUE if a clause is satisfied in the current state.
 
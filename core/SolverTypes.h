@@ -215,6 +215,10 @@ class ClauseAllocator : public RegionAllocator<uint32_t>{
         ClauseAllocator(uint32_t start_cap) : RegionAllocator<uint32_t>(start_cap), extra_clause_field(false){}
         ClauseAllocator() : extra_clause_field(false){}
 
+        // Make room for 'n_clauses' problem clauses with 'n_lits' literals in total:
+        void reserve(int n_clauses, int n_lits){
+            RegionAllocator<uint32_t>::reserve(clauseWord32Size(0, extra_clause_field) * n_clauses + n_lits); }
+
         void moveTo(ClauseAllocator& to){
             to.extra_clause_field = extra_clause_field;
             RegionAllocator<uint32_t>::moveTo(to);